@@ -25,7 +25,8 @@
  * Provides:
  *   - NCurses module registration (cels_register(NCurses))
  *   - Component types (NCurses_WindowConfig)
- *   - State singletons (NCurses_WindowState, NCurses_InputState)
+ *   - State singletons (NCurses_WindowState, NCurses_InputState,
+ *     NCurses_LatencyState)
  *   - Composition (NCursesWindow call macro)
  *   - Console logging (ncurses_console_log)
  *
@@ -37,6 +38,7 @@
 #define CELS_NCURSES_H
 #include <cels/cels.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 CEL_Module(NCurses);
 
@@ -51,13 +53,41 @@ CEL_Module(NCurses);
  *   NCursesWindow(.title = "My App", .fps = 60, .color_mode = 0) {}
  *
  * color_mode: 0=auto, 1=256-color, 2=palette-redef, 3=direct-RGB
+ * pipelined:  write terminal output on a background thread, overlapping it
+ *             with the next frame; frames are dropped while it is behind
+ * resize_debounce_ms: 0 = publish every terminal size change at once.
+ *             Otherwise NCurses_WindowState and fullscreen surfaces follow
+ *             the terminal only once its size has been stable this long;
+ *             in between, surfaces are cropped to the terminal.
+ * mouse_motion: NCURSES_MOTION_ALL (default) reports every pointer motion
+ *             as an event; NCURSES_MOTION_ENDPOINTS keeps only the first
+ *             and last point of each uninterrupted run of motion
+ * raw_input:  Decode input bytes with the built-in VT/xterm parser instead
+ *             of ncurses' keypad matching: Escape is reported without
+ *             ESCDELAY, every key carries its modifiers, and the kitty
+ *             keyboard protocol is used when the terminal supports it
+ * paused_fps: Frame rate while paused with F1 (default 10). OnLoad and
+ *             OnUpdate keep running at this rate; output is suspended
+ * input_thread: Read and decode input on a dedicated thread (implies
+ *             raw_input). Events carry their arrival time, and input
+ *             arriving during the FPS sleep starts the next frame at once
  */
 CEL_Component(NCurses_WindowConfig) {
     const char* title;
     int fps;
     int color_mode;
+    bool pipelined;
+    int resize_debounce_ms;
+    int mouse_motion;
+    bool raw_input;
+    bool input_thread;
+    int paused_fps;
 };
 
+/* NCurses_WindowConfig.mouse_motion */
+#define NCURSES_MOTION_ALL        0
+#define NCURSES_MOTION_ENDPOINTS  1
+
 /* ============================================================================
  * Surface Component Types
  * ============================================================================ */
@@ -81,6 +111,12 @@ CEL_Component(TUI_SurfaceConfig) {
     bool visible;       /* true = show_panel, false = hide_panel */
     int x, y;           /* Position (screen coordinates) */
     int width, height;  /* Dimensions (0,0 = fullscreen) */
+    bool retained;      /* Record draws; replay only when content changes */
+    bool offscreen;     /* Draw into a thread-safe cell buffer (see tui_render_parallel) */
+    bool opaque;        /* Fully covers whatever is stacked below it */
+    int virtual_width, virtual_height;  /* Content size (0 = no virtual content) */
+    int scroll_x, scroll_y;             /* Viewport offset into virtual content */
+    bool persistent;    /* Keep content between frames (no auto-clear) */
 };
 
 /*
@@ -111,10 +147,62 @@ CEL_Define_State(NCurses_WindowState) {
     int width;
     int height;
     bool running;
+    bool paused;            /* F1 pause: no terminal output until resumed */
     float actual_fps;
     float delta_time;
 };
 
+/*
+ * One input event, in the order it was read. time_ns is CLOCK_MONOTONIC
+ * at the moment the event was taken from the terminal input queue.
+ */
+typedef enum NCurses_InputEventType {
+    NCURSES_EVENT_KEY = 1,      /* key.code: raw ncurses key code */
+    NCURSES_EVENT_MOUSE,        /* mouse: position and button transition */
+    NCURSES_EVENT_RESIZE,       /* resize: terminal size when it was read */
+    NCURSES_EVENT_PASTE         /* paste: one complete bracketed paste */
+} NCurses_InputEventType;
+
+/* Modifier bits (NCurses_InputEvent.key.mods, .mouse.mods) */
+#define NCURSES_MOD_SHIFT   0x1
+#define NCURSES_MOD_ALT     0x2
+#define NCURSES_MOD_CTRL    0x4
+
+/* Button bits (NCurses_InputEvent.mouse.held) */
+#define NCURSES_HELD_LEFT   0x1
+#define NCURSES_HELD_MIDDLE 0x2
+#define NCURSES_HELD_RIGHT  0x4
+
+typedef struct NCurses_InputEvent {
+    NCurses_InputEventType type;
+    uint64_t time_ns;
+    union {
+        struct {
+            int code;
+            int mods;           /* NCURSES_MOD_* (always set with raw_input) */
+        } key;
+        struct {
+            int x, y;
+            int button;         /* 0=none (motion/wheel), 1=left, 2=middle, 3=right */
+            bool pressed;
+            bool released;
+            bool motion;        /* Pointer moved (a drag if held != 0) */
+            int wheel;          /* -1 = wheel up, +1 = wheel down, 0 = none */
+            int held;           /* NCURSES_HELD_* buttons down after this event */
+            int mods;           /* NCURSES_MOD_* */
+            cels_entity_t surface;  /* Topmost surface under x, y (0 = none) */
+            int local_x, local_y;   /* x, y relative to that surface */
+        } mouse;
+        struct {
+            int width, height;
+        } resize;
+        struct {
+            const char* text;   /* Pasted bytes (UTF-8, NUL-terminated) */
+            size_t length;      /* Bytes, excluding the terminator */
+        } paste;
+    };
+} NCurses_InputEvent;
+
 /*
  * Per-frame raw input state singleton. Updated each frame at OnLoad.
  * Read via cel_read(NCurses_InputState) in consumer systems.
@@ -123,20 +211,37 @@ CEL_Define_State(NCurses_WindowState) {
  * each key means (quit, accept, navigate, etc.) in their own systems.
  *
  * Per-frame fields reset each frame. Mouse position and held state persist.
+ *
+ * events[0..event_count) is the complete, lossless list of this frame's
+ * key, mouse and resize events. keys[] / mouse_* are summaries kept for
+ * compatibility: keys[] holds the first 16 keys, mouse_* the final state.
+ * events points into a buffer owned by the module that is reused (and
+ * only grown) across frames -- do not keep it past the frame.
  */
 CEL_Define_State(NCurses_InputState) {
-    /* Keyboard: all keys pressed this frame (per-frame, drained from getch queue) */
+    /* Keyboard: first 16 keys pressed this frame (per-frame, drained from getch queue) */
     int  keys[16];
     int  key_count;
 
+    /* All events this frame, in arrival order (per-frame, unbounded) */
+    const NCurses_InputEvent* events;
+    int  event_count;
+
+    /* Arrival times (CLOCK_MONOTONIC ns) of the oldest and newest event
+     * consumed this frame; 0 when the frame brought no input */
+    uint64_t input_oldest_ns;
+    uint64_t input_newest_ns;
+
     /* Mouse: position (persistent across frames) */
     int  mouse_x;
     int  mouse_y;
+    cels_entity_t mouse_surface;    /* Topmost surface under the pointer (0 = none) */
 
     /* Mouse: button event (per-frame) */
     int  mouse_button;      /* 0=none, 1=left, 2=middle, 3=right */
     bool mouse_pressed;
     bool mouse_released;
+    int  mouse_wheel;       /* Net wheel steps this frame (negative = up) */
 
     /* Mouse: held state (persistent across frames) */
     bool mouse_left_held;
@@ -144,6 +249,31 @@ CEL_Define_State(NCurses_InputState) {
     bool mouse_right_held;
 };
 
+/*
+ * Input-to-flush latency. Updated by TUI_FrameEndSystem after each
+ * doupdate() that shows a frame which consumed input: the time from that
+ * input's arrival to doupdate() returning. The histogram counts one sample
+ * per such frame, measured from its oldest input (the frame's worst case).
+ *
+ * histogram[i] counts latencies below NCURSES_LATENCY_BUCKET0_US << i;
+ * the last bucket also takes everything slower. Percentiles are the upper
+ * bound of the bucket they fall in. Set CELS_NCURSES_LATENCY_DUMP=<path>
+ * to write the histogram to a file at shutdown.
+ */
+#define NCURSES_LATENCY_BUCKETS    16
+#define NCURSES_LATENCY_BUCKET0_US 125
+
+CEL_Define_State(NCurses_LatencyState) {
+    uint64_t frames;            /* Flushed frames that consumed input */
+    uint64_t last_oldest_ns;    /* Last such frame: oldest input -> flush */
+    uint64_t last_newest_ns;    /* Last such frame: newest input -> flush */
+    uint64_t max_ns;
+    uint64_t p50_us;
+    uint64_t p90_us;
+    uint64_t p99_us;
+    uint32_t histogram[NCURSES_LATENCY_BUCKETS];
+};
+
 /* ============================================================================
  * Composition: NCursesWindow
  * ============================================================================
@@ -155,7 +285,9 @@ CEL_Define_State(NCurses_InputState) {
  *
  * Implementation in ncurses_module.c via CEL_Compose(NCursesWindow).
  */
-CEL_Define_Composition(NCursesWindow, const char* title; int fps; int color_mode;);
+CEL_Define_Composition(NCursesWindow, const char* title; int fps; int color_mode;
+                       bool pipelined; int resize_debounce_ms; int mouse_motion;
+                       bool raw_input; bool input_thread; int paused_fps;);
 
 /* Call macro for natural syntax */
 #define NCursesWindow(...) cel_init(NCursesWindow, __VA_ARGS__)
@@ -182,13 +314,84 @@ CEL_Define_Composition(NCursesWindow, const char* title; int fps; int color_mode
  * NOTE: .visible defaults to false (C99 zero-init). Pass .visible = true
  * explicitly to create a visible surface.
  *
+ * .retained = true records draw calls into a per-surface draw list instead
+ * of drawing immediately. The list is replayed at PostRender only when its
+ * content hash changed since the last frame; otherwise the WINDOW keeps its
+ * previous content and no ncurses work is done for the surface.
+ *
+ * .offscreen = true gives the surface an off-screen cell buffer instead:
+ * drawing never calls ncurses, so several offscreen surfaces can be drawn
+ * concurrently with tui_render_parallel(). The buffer is copied into the
+ * WINDOW at PostRender. Takes precedence over .retained.
+ *
+ * .opaque = true declares that the surface paints every cell of its rect,
+ * so surfaces below it can be culled where it covers them (see
+ * TUI_DrawContext_Component.visibility).
+ *
+ * .virtual_width / .virtual_height larger than the surface make it a
+ * viewport onto a pad of that size: ctx covers the whole pad, content is
+ * kept between frames (no auto-clear) and .scroll_x / .scroll_y pick the
+ * part that is shown. Scrolling only copies pad cells into the WINDOW;
+ * draw code runs only when the content itself changes. Takes precedence
+ * over .retained and .offscreen.
+ *
+ * .persistent = true skips the per-frame auto-clear: content stays until
+ * it is overwritten, so only changed cells need drawing. Combine with
+ * tui_surface_scroll() for tail-follow log panes. Ignored for retained
+ * surfaces, which re-record every frame.
+ *
  * Implementation in src/ncurses_module.c via CEL_Compose(TUISurface).
  */
-CEL_Define_Composition(TUISurface, int z_order; bool visible; int x; int y; int width; int height;);
+CEL_Define_Composition(TUISurface, int z_order; bool visible; int x; int y; int width; int height;
+                       bool retained; bool offscreen; bool opaque;
+                       int virtual_width; int virtual_height; int scroll_x; int scroll_y;
+                       bool persistent;);
 
 /* Call macro for natural syntax */
 #define TUISurface(...) cel_init(TUISurface, __VA_ARGS__)
 
+/* ============================================================================
+ * Surface Pool
+ * ============================================================================
+ *
+ * Destroyed surfaces park their hidden WINDOW/PANEL and sub-cell buffer in
+ * a pool keyed by size class (width and height rounded up to a power of
+ * two). A new surface in the same class reuses them instead of allocating,
+ * which keeps short-lived tooltips, popups and toasts cheap. Capacity
+ * defaults to 16 entries; 0 disables pooling.
+ */
+typedef struct NCurses_SurfacePoolStats {
+    uint64_t hits;          /* Surfaces created from a pooled WINDOW/PANEL */
+    uint64_t misses;        /* Surfaces that needed newwin/new_panel */
+    uint64_t recycled;      /* Destroyed surfaces parked in the pool */
+    uint64_t discarded;     /* Destroyed surfaces freed because the pool was full */
+    int pooled;             /* Entries currently parked */
+    int capacity;
+} NCurses_SurfacePoolStats;
+
+extern void ncurses_surface_pool_set_capacity(int capacity);
+extern NCurses_SurfacePoolStats ncurses_surface_pool_stats(void);
+
+/* ============================================================================
+ * Surface Hit Testing
+ * ============================================================================
+ *
+ * The module keeps a per-cell index of the topmost visible surface,
+ * rebuilt by TUI_SurfaceSystem when surfaces move, resize, show, hide or
+ * change z_order. Mouse events arrive already resolved against it
+ * (NCurses_InputEvent.mouse.surface); ncurses_surface_hit_test() answers
+ * the same question for any cell. entity is 0 when no surface covers the
+ * cell, and x/y are then the screen coordinates passed in. For virtual
+ * surfaces x/y are relative to the viewport: add scroll_x/scroll_y for
+ * content coordinates.
+ */
+typedef struct NCurses_SurfaceHit {
+    cels_entity_t entity;   /* Topmost visible surface at the cell (0 = none) */
+    int x, y;               /* Cell relative to that surface's top-left */
+} NCurses_SurfaceHit;
+
+extern NCurses_SurfaceHit ncurses_surface_hit_test(int x, int y);
+
 /* ============================================================================
  * Console Logging
  * ============================================================================
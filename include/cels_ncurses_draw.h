@@ -27,6 +27,8 @@
  *   - Sub-cell rendering (half-block, quadrant, braille)
  *   - Draw context
  *   - Drawing primitives (rects, text, borders, lines)
+ *   - Draw lists and off-screen cell buffers
+ *   - Parallel surface rendering
  *   - Scissor/clipping regions
  */
 
@@ -196,6 +198,10 @@ extern void tui_style_apply(WINDOW* win, TUI_Style style);
  * Pass -1 for auto-detection, or a TUI_ColorMode value to force a mode. */
 extern void tui_color_init(int mode_override);
 
+/* Drop the memoized color pair. Called when the pair table is reset
+ * (screen created or torn down); tui_color_init() does it itself. */
+extern void tui_color_forget_pair(void);
+
 /* Query the active color mode (returns TUI_ColorMode value). */
 extern TUI_ColorMode tui_color_get_mode(void);
 
@@ -254,10 +260,13 @@ typedef struct TUI_SubCell {
  * Grid of TUI_SubCell entries, one per terminal cell. Dimensions match the
  * layer's window dimensions. Allocated lazily on first sub-cell draw,
  * cleared at frame_begin alongside werase, resized with the layer.
+ * capacity grows geometrically, so repeated resizes re-stride the existing
+ * array instead of reallocating it.
  */
 typedef struct TUI_SubCellBuffer {
-    TUI_SubCell* cells;     /* width * height array */
+    TUI_SubCell* cells;     /* width * height array (capacity entries allocated) */
     int width, height;      /* Matches layer dimensions (in terminal cells) */
+    int capacity;           /* Allocated cells */
 } TUI_SubCellBuffer;
 
 /* ============================================================================
@@ -273,14 +282,37 @@ extern TUI_SubCellBuffer* tui_subcell_buffer_create(int width, int height);
  * Called from tui_frame_begin alongside werase. NULL-safe. */
 extern void tui_subcell_buffer_clear(TUI_SubCellBuffer* buf);
 
-/* Resize buffer to new dimensions, discarding old content.
- * Called from tui_layer_resize. NULL-safe. */
+/* Resize buffer to new dimensions, keeping the content of cells that are
+ * inside both the old and new size (new cells are NONE). Reallocates only
+ * when the new size exceeds capacity. NULL-safe. */
 extern void tui_subcell_buffer_resize(TUI_SubCellBuffer* buf, int width, int height);
 
+/* Shift rows by dy like wscrl(): positive dy moves content up, negative
+ * down. Exposed rows are reset to NONE. NULL-safe. */
+extern void tui_subcell_buffer_scroll(TUI_SubCellBuffer* buf, int dy);
+
 /* Free buffer memory (cells array + buffer struct).
  * Called from tui_layer_destroy. NULL-safe. */
 extern void tui_subcell_buffer_destroy(TUI_SubCellBuffer* buf);
 
+/* ============================================================================
+ * Scissor Stack
+ * ============================================================================
+ *
+ * Fixed-depth stack of clip rects owned by each draw context. rects[0] is
+ * always the base clip (full drawable area); sp indexes the current top.
+ * Living inside the context (instead of a file-scope global) means nested
+ * clipping on one surface never disturbs another, and draw contexts can be
+ * used from different threads independently.
+ */
+
+#define TUI_SCISSOR_STACK_MAX 16
+
+typedef struct TUI_ScissorStack {
+    TUI_CellRect rects[TUI_SCISSOR_STACK_MAX];
+    int sp;               /* Index of the current top (0 = base clip) */
+} TUI_ScissorStack;
+
 /* ============================================================================
  * Draw Context
  * ============================================================================
@@ -288,20 +320,32 @@ extern void tui_subcell_buffer_destroy(TUI_SubCellBuffer* buf);
  * All draw functions take TUI_DrawContext* as their first parameter.
  * No global "current context" -- caller passes the target explicitly.
  * The clip field represents the current effective clip rect.
+ *
+ * When list is non-NULL the context is in recording mode: draw functions
+ * append commands to the draw list instead of touching the WINDOW (see
+ * "Draw Lists" below). When cells is non-NULL draw functions write into
+ * that off-screen buffer and never call ncurses (see "Cell Buffers").
  */
 
+typedef struct TUI_DrawList TUI_DrawList;
+typedef struct TUI_CellBuffer TUI_CellBuffer;
+typedef struct TUI_SurfaceSlot TUI_SurfaceSlot;
+
 typedef struct TUI_DrawContext {
     WINDOW* win;          /* Borrowed -- caller manages lifetime */
     int x, y;             /* Origin offset within the window */
     int width, height;    /* Drawable area dimensions */
     TUI_CellRect clip;    /* Current effective clip rect (set by scissor stack) */
     TUI_SubCellBuffer** subcell_buf; /* Pointer to layer's buffer pointer (NULL for non-layer contexts) */
+    TUI_ScissorStack scissor;        /* Per-context clip stack (see tui_push_scissor) */
+    TUI_DrawList* list;              /* Recording target (NULL = draw immediately) */
+    TUI_CellBuffer* cells;           /* Off-screen target (NULL = draw into win) */
 } TUI_DrawContext;
 
 /*
  * Create a draw context wrapping an ncurses WINDOW.
- * Returns a stack-allocated context with clip initialized to the full
- * drawable area. The WINDOW* is borrowed, not owned.
+ * Returns a stack-allocated context with clip (and the scissor stack base)
+ * initialized to the full drawable area. The WINDOW* is borrowed, not owned.
  */
 static inline TUI_DrawContext tui_draw_context_create(WINDOW* win,
                                                       int x, int y,
@@ -314,9 +358,32 @@ static inline TUI_DrawContext tui_draw_context_create(WINDOW* win,
     ctx.height = height;
     ctx.clip = (TUI_CellRect){ .x = x, .y = y, .w = width, .h = height };
     ctx.subcell_buf = NULL;
+    ctx.list = NULL;
+    ctx.cells = NULL;
+    ctx.scissor.rects[0] = ctx.clip;
+    ctx.scissor.sp = 0;
     return ctx;
 }
 
+/* ============================================================================
+ * Surface Visibility -- Occlusion result per frame
+ * ============================================================================
+ *
+ * Computed at PreRender from surface rects, z-order and TUISurface(.opaque).
+ * A surface is covered only by visible opaque surfaces stacked above it.
+ * PARTIAL lists the uncovered parts in visible_rects (surface coordinates,
+ * at most TUI_VISIBLE_RECTS_MAX; when the exact shape needs more, the
+ * result stays conservative and may include some covered cells).
+ */
+
+#define TUI_VISIBLE_RECTS_MAX 8
+
+typedef enum TUI_Visibility {
+    TUI_VISIBILITY_FULL = 0,    /* Nothing covers the surface */
+    TUI_VISIBILITY_PARTIAL,     /* Some cells covered; see visible_rects */
+    TUI_VISIBILITY_OCCLUDED     /* Hidden, or completely covered */
+} TUI_Visibility;
+
 /* ============================================================================
  * Surface Entity Component -- Attached by NCurses, read by developer
  * ============================================================================
@@ -326,6 +393,18 @@ static inline TUI_DrawContext tui_draw_context_create(WINDOW* win,
  * drawable surface. The developer uses the inner .ctx field with tui_draw_*
  * functions. Internal fields (panel, win, subcell_buf) are opaque.
  *
+ * visibility is refreshed every frame before OnRender. Render systems can
+ * skip OCCLUDED surfaces outright; for PARTIAL surfaces ctx.clip (and the
+ * scissor base) is narrowed to the bounding box of visible_rects, and
+ * for OCCLUDED surfaces it is empty, so draw calls are clipped away.
+ *
+ * Persistent surfaces keep the full clip: they are never cleared, so cells
+ * skipped while covered would show stale content once uncovered.
+ *
+ * Virtual surfaces (TUI_SurfaceConfig.virtual_width/height) draw into pad:
+ * ctx spans the whole virtual content and is never narrowed by occlusion,
+ * and scroll_x/scroll_y hold the clamped viewport offset.
+ *
  * CEL_Component(TUI_DrawContext_Component) is forward-declared in
  * cels_ncurses.h. This struct definition completes the type.
  */
@@ -335,8 +414,29 @@ struct TUI_DrawContext_Component {
     PANEL* panel;                  /* Internal: ncurses panel (do not access directly) */
     WINDOW* win;                   /* Internal: ncurses window (do not access directly) */
     TUI_SubCellBuffer* subcell_buf; /* Internal: lazy-allocated sub-cell buffer */
+    TUI_DrawList* draw_list;       /* Internal: command buffer (retained surfaces only) */
+    TUI_CellBuffer* cell_buf;      /* Internal: off-screen cells (offscreen surfaces only) */
+    WINDOW* pad;                   /* Internal: virtual content (virtual surfaces only) */
+    int scroll_x, scroll_y;        /* Viewport offset into the pad (virtual surfaces only) */
+    TUI_SurfaceSlot* slot;         /* Internal: z-order registry entry */
+    TUI_Visibility visibility;     /* Occlusion result for this frame */
+    int visible_rect_count;        /* Entries in visible_rects (PARTIAL only) */
+    TUI_CellRect visible_rects[TUI_VISIBLE_RECTS_MAX]; /* Uncovered parts */
 };
 
+/*
+ * Shift a surface's existing content by dy rows (positive = up, like a log
+ * pane following its tail; negative = down) and blank the exposed rows.
+ * The caller then draws only those rows. Meant for .persistent surfaces,
+ * whose content survives between frames.
+ *
+ * Surfaces spanning the full terminal width get idlok(), so ncurses can
+ * emit the shift as a terminal scroll region / insert-delete line instead
+ * of resending every row. Retained surfaces replay their next list in full.
+ * Call from the ncurses thread (e.g. in OnRender before drawing).
+ */
+extern void tui_surface_scroll(struct TUI_DrawContext_Component* dc, int dy);
+
 /* ============================================================================
  * Drawing Primitives - Types
  * ============================================================================ */
@@ -513,6 +613,196 @@ extern void tui_draw_subcell_resolution(TUI_DrawContext* ctx,
                                           TUI_SubCellMode mode,
                                           int* width, int* height);
 
+/* ============================================================================
+ * Draw Lists -- Recorded draw commands with replay and culling
+ * ============================================================================
+ *
+ * A draw list is a compact command buffer for one surface. While a context
+ * has ctx->list set, every tui_draw_* call is recorded instead of drawn.
+ * tui_draw_list_replay() later issues the commands into the real WINDOW.
+ *
+ * Recording allows work to be skipped without changing draw code:
+ *   - commands entirely outside ctx->clip are dropped at record time
+ *   - commands completely covered by a later fill_rect are skipped on replay
+ *   - a list whose content hash equals the last replayed list reports
+ *     unchanged, so the caller can leave the WINDOW as it is
+ *
+ * Command and text storage are arenas reused across frames: after warm-up,
+ * recording performs no allocation. Sub-cell commands are never culled by
+ * overdraw because they update the persistent sub-cell shadow buffer.
+ *
+ * Surfaces created with TUISurface(.retained = true) record automatically;
+ * NCurses replays them at PostRender only when their content changed.
+ */
+
+typedef enum TUI_DrawOp {
+    TUI_DRAW_OP_FILL_RECT,
+    TUI_DRAW_OP_BORDER_RECT,
+    TUI_DRAW_OP_BORDER,
+    TUI_DRAW_OP_TEXT,
+    TUI_DRAW_OP_HLINE,
+    TUI_DRAW_OP_VLINE,
+    TUI_DRAW_OP_HALFBLOCK_PLOT,
+    TUI_DRAW_OP_HALFBLOCK_FILL,
+    TUI_DRAW_OP_QUADRANT_PLOT,
+    TUI_DRAW_OP_QUADRANT_FILL,
+    TUI_DRAW_OP_BRAILLE_PLOT,
+    TUI_DRAW_OP_BRAILLE_UNPLOT,
+    TUI_DRAW_OP_BRAILLE_FILL
+} TUI_DrawOp;
+
+/*
+ * One recorded command. rect holds the call's geometry in the units of the
+ * original call (cells, or virtual pixels for sub-cell ops; line length in
+ * rect.w / rect.h). clip is ctx->clip at record time.
+ */
+typedef struct TUI_DrawCmd {
+    uint8_t op;             /* TUI_DrawOp */
+    uint8_t border_style;   /* TUI_BorderStyle (border and line ops) */
+    uint8_t sides;          /* TUI_SIDE_* mask (TUI_DRAW_OP_BORDER) */
+    TUI_CellRect rect;      /* Geometry of the original call */
+    TUI_CellRect clip;      /* Effective clip when recorded */
+    TUI_Style style;
+    chtype fill_ch;         /* TUI_DRAW_OP_FILL_RECT character */
+    uint32_t text_off;      /* TUI_DRAW_OP_TEXT: offset into the text arena */
+    uint32_t text_len;      /* TUI_DRAW_OP_TEXT: byte length (excluding NUL) */
+} TUI_DrawCmd;
+
+struct TUI_DrawList {
+    TUI_DrawCmd* cmds;      /* Command arena (capacity grows, never shrinks) */
+    int count, capacity;
+    char* text;             /* NUL-separated text arena */
+    uint32_t text_len, text_cap;
+    int* scratch;           /* Replay scratch (per-command overdraw marks) */
+    int scratch_cap;
+    uint64_t hash;          /* Running content hash of the current recording */
+    uint64_t last_hash;     /* Content hash of the last replayed list */
+    bool has_last;          /* false until first replay / after invalidate */
+    int culled;             /* Commands dropped since the last begin */
+};
+
+/* Allocate an empty draw list. Returns NULL on allocation failure. */
+extern TUI_DrawList* tui_draw_list_create(void);
+
+/* Free a draw list and its arenas. NULL-safe. */
+extern void tui_draw_list_destroy(TUI_DrawList* list);
+
+/* Start a new recording: drops all commands, keeps arena capacity. */
+extern void tui_draw_list_begin(TUI_DrawList* list);
+
+/* Forget the last replayed hash so the next tui_draw_list_changed()
+ * returns true (call after the target WINDOW was resized or cleared). */
+extern void tui_draw_list_invalidate(TUI_DrawList* list);
+
+/* True if the recorded content differs from the last replayed content. */
+extern bool tui_draw_list_changed(const TUI_DrawList* list);
+
+/* Issue all non-culled commands into target (whose list must be NULL or
+ * differ from this list) and remember the content hash. */
+extern void tui_draw_list_replay(TUI_DrawList* list, TUI_DrawContext* target);
+
+/* Append a command to ctx->list. Called by the tui_draw_* primitives when
+ * ctx->list is set; text is copied into the arena (may be NULL). Returns
+ * false only if the command could not be stored. */
+extern bool tui_draw_list_record(TUI_DrawContext* ctx, const TUI_DrawCmd* cmd,
+                                  const char* text);
+
+/* ============================================================================
+ * Cell Buffers -- Off-screen, thread-private surface targets
+ * ============================================================================
+ *
+ * A cell buffer holds one glyph and one TUI_Style per cell, plus the sub-cell
+ * shadow state for the surface. While ctx->cells is set the tui_draw_*
+ * primitives write into the buffer and make no ncurses calls, so different
+ * surfaces can be drawn concurrently (see tui_render_parallel below).
+ *
+ * tui_cell_buffer_commit() copies the buffer into its WINDOW on the ncurses
+ * thread. Only rows drawn since the last clear are written; rows that held
+ * content at the previous commit but were not redrawn are erased.
+ *
+ * Surfaces created with TUISurface(.offscreen = true) draw into a cell
+ * buffer automatically; NCurses commits them at PostRender.
+ */
+
+/* Row flags in TUI_CellBuffer.rows */
+#define TUI_CELL_ROW_DRAWN 0x01     /* Written since the last clear */
+#define TUI_CELL_ROW_SHOWN 0x02     /* WINDOW row holds committed content */
+
+typedef struct TUI_Cell {
+    wchar_t ch;             /* Glyph; 0 marks the right half of a wide glyph */
+    TUI_Style style;
+} TUI_Cell;
+
+struct TUI_CellBuffer {
+    TUI_Cell* cells;        /* width * height, row-major */
+    uint8_t* rows;          /* Per-row TUI_CELL_ROW_* flags */
+    wchar_t* line;          /* Commit scratch (one row of glyphs) */
+    int width, height;
+    int cell_cap, row_cap, line_cap;  /* Allocated entries (grow geometrically) */
+    TUI_Style pen;          /* Style for subsequent writes (set by primitives) */
+    TUI_SubCellBuffer* subcell; /* Sub-cell shadow state (lazy, see ctx->subcell_buf) */
+};
+
+/* Allocate a blank cell buffer. Returns NULL on allocation failure. */
+extern TUI_CellBuffer* tui_cell_buffer_create(int width, int height);
+
+/* Free a cell buffer and its sub-cell state. NULL-safe. */
+extern void tui_cell_buffer_destroy(TUI_CellBuffer* buf);
+
+/* Resize, keeping cells and row flags inside both the old and new size
+ * (the WINDOW is resized in place with wresize). NULL-safe. */
+extern void tui_cell_buffer_resize(TUI_CellBuffer* buf, int width, int height);
+
+/* Blank every row drawn since the last clear and reset sub-cell state.
+ * NULL-safe. */
+extern void tui_cell_buffer_clear(TUI_CellBuffer* buf);
+
+/* Shift rows by dy like wscrl() (positive = up) and blank the exposed
+ * rows. Every row is re-committed once afterwards. NULL-safe. */
+extern void tui_cell_buffer_scroll(TUI_CellBuffer* buf, int dy);
+
+/* Write one glyph at (x, y) using buf->pen. Wide glyphs occupy two cells;
+ * zero-width glyphs and out-of-bounds writes are ignored. */
+extern void tui_cell_buffer_put(TUI_CellBuffer* buf, int x, int y, wchar_t ch);
+
+/* Copy drawn rows into win. Must run on the ncurses thread. NULL-safe. */
+extern void tui_cell_buffer_commit(TUI_CellBuffer* buf, WINDOW* win);
+
+/* ============================================================================
+ * Parallel Rendering
+ * ============================================================================
+ *
+ * tui_render_parallel() runs one draw callback per job on a lazily started
+ * worker pool (one thread per extra online CPU, at most
+ * TUI_RENDER_MAX_WORKERS) and returns once every job has finished. The
+ * calling thread takes part in the work.
+ *
+ * Only jobs whose ctx->cells is set run on workers; any other job would
+ * touch ncurses and is run on the calling thread after the batch. Each job
+ * must target a different context.
+ *
+ * Callbacks must not call ncurses. tui_color_rgb() is safe in the 256 and
+ * direct color modes; in TUI_COLOR_MODE_PALETTE it allocates palette slots,
+ * so resolve colors before dispatching.
+ */
+
+#define TUI_RENDER_MAX_WORKERS 15
+
+typedef void (*TUI_RenderFn)(TUI_DrawContext* ctx, void* user);
+
+typedef struct TUI_RenderJob {
+    TUI_DrawContext* ctx;   /* Target (usually &dc->ctx of an offscreen surface) */
+    TUI_RenderFn fn;
+    void* user;
+} TUI_RenderJob;
+
+/* Run all jobs, in parallel where possible. Blocks until all complete. */
+extern void tui_render_parallel(TUI_RenderJob* jobs, int count);
+
+/* Stop and join the worker pool (restarted on next use). Called by NCurses
+ * at terminal shutdown. */
+extern void tui_render_pool_shutdown(void);
+
 /* ============================================================================
  * Internal Helpers
  * ============================================================================ */
@@ -527,10 +817,10 @@ extern TUI_BorderChars tui_border_chars_get(TUI_BorderStyle border_style);
  * tui_scissor_reset  -- Clear stack and set base clip to full drawable area.
  * tui_push_scissor   -- Push a new clip rect (intersected with current top).
  * tui_pop_scissor    -- Pop the top clip rect, restoring the previous one.
+ *
+ * All three operate on ctx->scissor, so each context clips independently.
  */
 
-#define TUI_SCISSOR_STACK_MAX 16
-
 extern void tui_scissor_reset(TUI_DrawContext* ctx);
 extern void tui_push_scissor(TUI_DrawContext* ctx, TUI_CellRect rect);
 extern void tui_pop_scissor(TUI_DrawContext* ctx);
@@ -0,0 +1,288 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * TUI Cell Buffer - Off-screen surface target
+ *
+ * Implements create/clear/resize/destroy, glyph writes and the commit into
+ * an ncurses WINDOW. Everything except tui_cell_buffer_commit() is plain
+ * memory work and safe to call from a worker thread, as long as each buffer
+ * is used by one thread at a time.
+ *
+ * Wide glyphs store the glyph in the left cell and 0 in the right cell.
+ * Overwriting either half of a wide glyph blanks the other half so that a
+ * committed row never shifts.
+ */
+
+#include <cels_ncurses_draw.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+static const TUI_Cell BLANK_CELL = {
+    .ch = L' ',
+    .style = { .fg = { -1 }, .bg = { -1 }, .attrs = TUI_ATTR_NORMAL }
+};
+
+static bool style_equal(TUI_Style a, TUI_Style b) {
+    return a.fg.index == b.fg.index && a.bg.index == b.bg.index
+        && a.attrs == b.attrs;
+}
+
+static bool cell_is_blank(const TUI_Cell* cell) {
+    return cell->ch == L' ' && style_equal(cell->style, BLANK_CELL.style);
+}
+
+static void blank_row(TUI_Cell* row, int width) {
+    for (int x = 0; x < width; x++) row[x] = BLANK_CELL;
+}
+
+/* Allocate cells/rows/line for the given size. Returns false on failure
+ * (buffer left with no storage). */
+static bool cell_buffer_alloc(TUI_CellBuffer* buf, int width, int height) {
+    if (width < 0) width = 0;
+    if (height < 0) height = 0;
+
+    int count = width * height;
+    buf->cell_cap = count ? count : 1;
+    buf->row_cap = height ? height : 1;
+    buf->line_cap = width + 1;
+    buf->cells = malloc((size_t)buf->cell_cap * sizeof(TUI_Cell));
+    buf->rows = calloc((size_t)buf->row_cap, sizeof(uint8_t));
+    buf->line = malloc((size_t)buf->line_cap * sizeof(wchar_t));
+    if (!buf->cells || !buf->rows || !buf->line) {
+        free(buf->cells);
+        free(buf->rows);
+        free(buf->line);
+        buf->cells = NULL;
+        buf->rows = NULL;
+        buf->line = NULL;
+        buf->width = 0;
+        buf->height = 0;
+        return false;
+    }
+
+    buf->width = width;
+    buf->height = height;
+    for (int y = 0; y < height; y++) blank_row(&buf->cells[y * width], width);
+    return true;
+}
+
+/* ============================================================================
+ * Lifecycle
+ * ============================================================================ */
+
+TUI_CellBuffer* tui_cell_buffer_create(int width, int height) {
+    TUI_CellBuffer* buf = calloc(1, sizeof(TUI_CellBuffer));
+    if (!buf) return NULL;
+
+    if (!cell_buffer_alloc(buf, width, height)) {
+        free(buf);
+        return NULL;
+    }
+    buf->pen = BLANK_CELL.style;
+    return buf;
+}
+
+void tui_cell_buffer_destroy(TUI_CellBuffer* buf) {
+    if (!buf) return;
+    tui_subcell_buffer_destroy(buf->subcell);
+    free(buf->cells);
+    free(buf->rows);
+    free(buf->line);
+    free(buf);
+}
+
+/* Grow arr to hold need elements (capacity at least doubles). Returns the
+ * possibly moved array, or NULL on failure with arr left untouched. */
+static void* grow(void* arr, int* cap, int need, size_t elem) {
+    if (need <= *cap) return arr;
+    int c = *cap * 2;
+    if (c < need) c = need;
+    void* p = realloc(arr, (size_t)c * elem);
+    if (p) *cap = c;
+    return p;
+}
+
+/* Re-stride in place like tui_subcell_buffer_resize: kept rows move to the
+ * new stride (bottom-up when widening, top-down when narrowing), new cells
+ * are blank. Row flags stay valid because wresize keeps the WINDOW rows
+ * that are still inside the new size. */
+void tui_cell_buffer_resize(TUI_CellBuffer* buf, int width, int height) {
+    if (!buf) return;
+    if (width < 0) width = 0;
+    if (height < 0) height = 0;
+
+    void* p = grow(buf->cells, &buf->cell_cap, width * height, sizeof(TUI_Cell));
+    if (!p) return;
+    buf->cells = p;
+    p = grow(buf->rows, &buf->row_cap, height, sizeof(uint8_t));
+    if (!p) return;
+    buf->rows = p;
+    p = grow(buf->line, &buf->line_cap, width + 1, sizeof(wchar_t));
+    if (!p) return;
+    buf->line = p;
+
+    int old_w = buf->width;
+    int keep_rows = height < buf->height ? height : buf->height;
+    int keep_cols = width < old_w ? width : old_w;
+
+    if (width > old_w) {
+        for (int y = keep_rows - 1; y >= 0; y--) {
+            memmove(&buf->cells[y * width], &buf->cells[y * old_w],
+                    (size_t)keep_cols * sizeof(TUI_Cell));
+            blank_row(&buf->cells[y * width + keep_cols], width - keep_cols);
+        }
+    } else if (width < old_w) {
+        for (int y = 0; y < keep_rows; y++) {
+            TUI_Cell* src = &buf->cells[y * old_w];
+            /* A wide glyph cut by the new edge loses its right half */
+            if (width > 0 && src[width].ch == 0) src[width - 1].ch = L' ';
+            memmove(&buf->cells[y * width], src, (size_t)keep_cols * sizeof(TUI_Cell));
+        }
+    }
+    for (int y = keep_rows; y < height; y++) {
+        blank_row(&buf->cells[y * width], width);
+        buf->rows[y] = 0;
+    }
+
+    buf->width = width;
+    buf->height = height;
+    tui_subcell_buffer_resize(buf->subcell, width, height);
+}
+
+void tui_cell_buffer_clear(TUI_CellBuffer* buf) {
+    if (!buf) return;
+    for (int y = 0; y < buf->height; y++) {
+        if (!(buf->rows[y] & TUI_CELL_ROW_DRAWN)) continue;
+        blank_row(&buf->cells[y * buf->width], buf->width);
+        buf->rows[y] &= (uint8_t)~TUI_CELL_ROW_DRAWN;
+    }
+    tui_subcell_buffer_clear(buf->subcell);
+}
+
+/* Shift rows like wscrl(). The WINDOW itself is not scrolled, so every
+ * row is marked SHOWN: the next commit rewrites (or blanks) each row once
+ * and ncurses' own scroll detection turns the result into a scroll. */
+void tui_cell_buffer_scroll(TUI_CellBuffer* buf, int dy) {
+    if (!buf || dy == 0 || buf->height == 0) return;
+    int n = dy > 0 ? dy : -dy;
+    if (n > buf->height) n = buf->height;
+    int kept = buf->height - n;
+    size_t row = (size_t)buf->width * sizeof(TUI_Cell);
+
+    if (dy > 0) {
+        memmove(buf->cells, &buf->cells[n * buf->width], (size_t)kept * row);
+        memmove(buf->rows, &buf->rows[n], (size_t)kept);
+        for (int y = kept; y < buf->height; y++) {
+            blank_row(&buf->cells[y * buf->width], buf->width);
+            buf->rows[y] = 0;
+        }
+    } else {
+        memmove(&buf->cells[n * buf->width], buf->cells, (size_t)kept * row);
+        memmove(&buf->rows[n], buf->rows, (size_t)kept);
+        for (int y = 0; y < n; y++) {
+            blank_row(&buf->cells[y * buf->width], buf->width);
+            buf->rows[y] = 0;
+        }
+    }
+    for (int y = 0; y < buf->height; y++) buf->rows[y] |= TUI_CELL_ROW_SHOWN;
+    tui_subcell_buffer_scroll(buf->subcell, dy);
+}
+
+/* ============================================================================
+ * Glyph Writes
+ * ============================================================================ */
+
+/* Blank the other half of a wide glyph that cell x is part of */
+static void unlink_wide(TUI_Cell* row, int width, int x) {
+    if (row[x].ch == 0 && x > 0) {
+        row[x - 1].ch = L' ';
+    } else if (x + 1 < width && row[x + 1].ch == 0) {
+        row[x + 1].ch = L' ';
+    }
+}
+
+void tui_cell_buffer_put(TUI_CellBuffer* buf, int x, int y, wchar_t ch) {
+    int cw = wcwidth(ch);
+    if (cw <= 0) return;
+    if (y < 0 || y >= buf->height || x < 0 || x + cw > buf->width) return;
+
+    TUI_Cell* row = &buf->cells[y * buf->width];
+    for (int i = x; i < x + cw; i++) unlink_wide(row, buf->width, i);
+
+    row[x] = (TUI_Cell){ .ch = ch, .style = buf->pen };
+    if (cw == 2) row[x + 1] = (TUI_Cell){ .ch = 0, .style = buf->pen };
+    buf->rows[y] |= TUI_CELL_ROW_DRAWN;
+}
+
+/* ============================================================================
+ * Commit
+ * ============================================================================
+ *
+ * Each drawn row is erased and rewritten as runs of equal style, one
+ * tui_style_apply + mvwaddnwstr per run. Default-styled blanks end a run
+ * and are not written (wclrtoeol already blanked them). ncurses still
+ * diffs the result against the screen at doupdate().
+ */
+
+void tui_cell_buffer_commit(TUI_CellBuffer* buf, WINDOW* win) {
+    if (!buf || !win) return;
+
+    /* The WINDOW can be smaller than the buffer while a terminal resize
+     * settles; rows past its bottom are skipped (wmove would fail and
+     * wclrtoeol hit the wrong row) */
+    int rows = getmaxy(win);
+    if (rows > buf->height) rows = buf->height;
+
+    for (int y = 0; y < rows; y++) {
+        uint8_t flags = buf->rows[y];
+        if (!(flags & (TUI_CELL_ROW_DRAWN | TUI_CELL_ROW_SHOWN))) continue;
+
+        wmove(win, y, 0);
+        wclrtoeol(win);
+        if (!(flags & TUI_CELL_ROW_DRAWN)) {
+            buf->rows[y] &= (uint8_t)~TUI_CELL_ROW_SHOWN;
+            continue;
+        }
+        buf->rows[y] |= TUI_CELL_ROW_SHOWN;
+
+        const TUI_Cell* row = &buf->cells[y * buf->width];
+        int x = 0;
+        while (x < buf->width) {
+            if (row[x].ch == 0 || cell_is_blank(&row[x])) {
+                x++;
+                continue;
+            }
+
+            int start = x;
+            int n = 0;
+            TUI_Style style = row[x].style;
+            while (x < buf->width) {
+                if (row[x].ch != 0) {
+                    if (cell_is_blank(&row[x])) break;
+                    if (!style_equal(row[x].style, style)) break;
+                    buf->line[n++] = row[x].ch;
+                }
+                x++;
+            }
+            buf->line[n] = L'\0';
+
+            tui_style_apply(win, style);
+            mvwaddnwstr(win, y, start, buf->line, n);
+        }
+    }
+}
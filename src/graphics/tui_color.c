@@ -183,18 +183,46 @@ static attr_t tui_attrs_to_ncurses(uint32_t flags) {
     return a;
 }
 
+/*
+ * Single-entry memo of the last alloc_pair() result. Consecutive draws
+ * (and draw-list replays) overwhelmingly reuse the same colors, so this
+ * skips the pair-table lookup. Safe against LRU eviction: the memoized
+ * pair is always the most recently allocated one. The pair table belongs
+ * to the current screen, so tui_color_forget_pair() drops the memo
+ * wherever that table is created or torn down. Like every WINDOW write,
+ * tui_style_apply() runs on the ncurses thread only; cell-buffer drawing
+ * on render workers never reaches it.
+ */
+static int g_last_pair_fg = -1;
+static int g_last_pair_bg = -1;
+static int g_last_pair = 0;
+
 void tui_style_apply(WINDOW* win, TUI_Style style) {
     int pair;
     if (style.fg.index == -1 && style.bg.index == -1) {
         pair = 0;  /* Default pair -- no alloc needed */
+    } else if (g_last_pair > 0 && style.fg.index == g_last_pair_fg &&
+               style.bg.index == g_last_pair_bg) {
+        pair = g_last_pair;
     } else {
         pair = alloc_pair(style.fg.index, style.bg.index);
+        g_last_pair_fg = style.fg.index;
+        g_last_pair_bg = style.bg.index;
+        g_last_pair = pair;
     }
     attr_t attrs = tui_attrs_to_ncurses(style.attrs);
     wattr_set(win, attrs, 0, &pair);
 }
 
+void tui_color_forget_pair(void) {
+    g_last_pair_fg = -1;
+    g_last_pair_bg = -1;
+    g_last_pair = 0;
+}
+
 void tui_color_init(int mode_override) {
+    tui_color_forget_pair();  /* Pair table belongs to the (new) screen */
+
     if (mode_override >= 0) {
         g_color_mode = (TUI_ColorMode)mode_override;
         return;
@@ -22,6 +22,11 @@
  * TUI_DrawContext.clip before issuing ncurses calls. No function calls
  * wrefresh, wnoutrefresh, or doupdate.
  *
+ * When ctx->list is set every primitive records a TUI_DrawCmd instead of
+ * drawing (see tui_draw_list.c); replay calls back into these functions.
+ * When ctx->cells is set the draw_* output helpers below write into the
+ * off-screen cell buffer instead of the WINDOW (see tui_cell_buffer.c).
+ *
  * Supported border styles:
  *   SINGLE  - WACS_HLINE/WACS_VLINE with WACS_*CORNER macros
  *   DOUBLE  - WACS_D_HLINE/WACS_D_VLINE with WACS_D_*CORNER macros
@@ -141,6 +146,111 @@ TUI_BorderChars tui_border_chars_get(TUI_BorderStyle border_style) {
     return chars;
 }
 
+/* ============================================================================
+ * Output Helpers
+ * ============================================================================
+ *
+ * Every primitive writes through these helpers. Without a cell buffer they
+ * are the plain ncurses calls; with one they only touch ctx->cells, which
+ * keeps cell-buffer drawing free of ncurses state (and thread-safe).
+ */
+
+static void draw_style(TUI_DrawContext* ctx, TUI_Style style) {
+    if (ctx->cells) {
+        ctx->cells->pen = style;
+        return;
+    }
+    tui_style_apply(ctx->win, style);
+}
+
+/* ncurses video attributes as TUI_ATTR flags (color bits are ignored) */
+static uint32_t draw_attrs_from_ncurses(attr_t a) {
+    uint32_t flags = TUI_ATTR_NORMAL;
+    if (a & A_BOLD)      flags |= TUI_ATTR_BOLD;
+    if (a & A_DIM)       flags |= TUI_ATTR_DIM;
+    if (a & A_UNDERLINE) flags |= TUI_ATTR_UNDERLINE;
+    if (a & A_REVERSE)   flags |= TUI_ATTR_REVERSE;
+#ifdef A_ITALIC
+    if (a & A_ITALIC)    flags |= TUI_ATTR_ITALIC;
+#endif
+    return flags;
+}
+
+/* Put one cell, adding the character's own attributes to the pen the way
+ * waddch() combines them with the window attributes */
+static void draw_cell(TUI_DrawContext* ctx, int y, int x, wchar_t wc, attr_t attrs) {
+    uint32_t extra = draw_attrs_from_ncurses(attrs);
+    if (!extra) {
+        tui_cell_buffer_put(ctx->cells, x, y, wc);
+        return;
+    }
+    uint32_t pen_attrs = ctx->cells->pen.attrs;
+    ctx->cells->pen.attrs |= extra;
+    tui_cell_buffer_put(ctx->cells, x, y, wc);
+    ctx->cells->pen.attrs = pen_attrs;
+}
+
+static void draw_wch(TUI_DrawContext* ctx, int y, int x, const cchar_t* cc) {
+    if (ctx->cells) {
+        wchar_t wc[CCHARW_MAX + 1];
+        attr_t attrs;
+        short pair;
+        if (getcchar(cc, wc, &attrs, &pair, NULL) == ERR) return;
+        draw_cell(ctx, y, x, wc[0], attrs);
+        return;
+    }
+    mvwadd_wch(ctx->win, y, x, cc);
+}
+
+static void draw_ch(TUI_DrawContext* ctx, int y, int x, chtype ch) {
+    if (ctx->cells) {
+        attr_t attrs = (attr_t)(ch & A_ATTRIBUTES & ~(A_ALTCHARSET | A_COLOR));
+        if (ch & A_ALTCHARSET) {
+            wchar_t wc[CCHARW_MAX + 1];
+            attr_t acs_attrs;
+            short pair;
+            if (getcchar(NCURSES_WACS(ch & A_CHARTEXT), wc, &acs_attrs, &pair, NULL) == ERR) return;
+            draw_cell(ctx, y, x, wc[0], attrs | acs_attrs);
+        } else {
+            draw_cell(ctx, y, x, (wchar_t)(ch & A_CHARTEXT), attrs);
+        }
+        return;
+    }
+    mvwaddch(ctx->win, y, x, ch);
+}
+
+static void draw_hline_set(TUI_DrawContext* ctx, int y, int x,
+                           const cchar_t* cc, int n) {
+    if (ctx->cells) {
+        for (int i = 0; i < n; i++) draw_wch(ctx, y, x + i, cc);
+        return;
+    }
+    mvwhline_set(ctx->win, y, x, cc, n);
+}
+
+static void draw_vline_set(TUI_DrawContext* ctx, int y, int x,
+                           const cchar_t* cc, int n) {
+    if (ctx->cells) {
+        for (int i = 0; i < n; i++) draw_wch(ctx, y + i, x, cc);
+        return;
+    }
+    mvwvline_set(ctx->win, y, x, cc, n);
+}
+
+static void draw_wstr(TUI_DrawContext* ctx, int y, int x,
+                      const wchar_t* wstr, int n) {
+    if (ctx->cells) {
+        for (int i = 0; i < n; i++) {
+            int cw = wcwidth(wstr[i]);
+            if (cw <= 0) continue;
+            tui_cell_buffer_put(ctx->cells, x, y, wstr[i]);
+            x += cw;
+        }
+        return;
+    }
+    mvwaddnwstr(ctx->win, y, x, wstr, n);
+}
+
 /* ============================================================================
  * Filled Rectangle (DRAW-01)
  * ============================================================================
@@ -151,13 +261,21 @@ TUI_BorderChars tui_border_chars_get(TUI_BorderStyle border_style) {
 
 void tui_draw_fill_rect(TUI_DrawContext* ctx, TUI_CellRect rect,
                          chtype fill_ch, TUI_Style style) {
+    if (ctx->list) {
+        tui_draw_list_record(ctx, &(TUI_DrawCmd){
+            .op = TUI_DRAW_OP_FILL_RECT, .rect = rect,
+            .style = style, .fill_ch = fill_ch
+        }, NULL);
+        return;
+    }
+
     TUI_CellRect visible = tui_cell_rect_intersect(rect, ctx->clip);
     if (visible.w <= 0 || visible.h <= 0) return;
 
-    tui_style_apply(ctx->win, style);
+    draw_style(ctx, style);
     for (int row = visible.y; row < visible.y + visible.h; row++) {
         for (int col = visible.x; col < visible.x + visible.w; col++) {
-            mvwaddch(ctx->win, row, col, fill_ch);
+            draw_ch(ctx, row, col, fill_ch);
         }
     }
 }
@@ -176,9 +294,16 @@ void tui_draw_border_rect(TUI_DrawContext* ctx, TUI_CellRect rect,
                            TUI_BorderStyle border_style, TUI_Style style) {
     if (rect.w < 2 || rect.h < 2) return;
     if (border_style == TUI_BORDER_NONE) return;
+    if (ctx->list) {
+        tui_draw_list_record(ctx, &(TUI_DrawCmd){
+            .op = TUI_DRAW_OP_BORDER_RECT, .rect = rect,
+            .border_style = (uint8_t)border_style, .style = style
+        }, NULL);
+        return;
+    }
 
     TUI_BorderChars chars = tui_border_chars_get(border_style);
-    tui_style_apply(ctx->win, style);
+    draw_style(ctx, style);
 
     int x1 = rect.x;
     int y1 = rect.y;
@@ -187,43 +312,43 @@ void tui_draw_border_rect(TUI_DrawContext* ctx, TUI_CellRect rect,
 
     /* Corners */
     if (tui_cell_rect_contains(ctx->clip, x1, y1)) {
-        mvwadd_wch(ctx->win, y1, x1, chars.ul);
+        draw_wch(ctx, y1, x1, chars.ul);
     }
     if (tui_cell_rect_contains(ctx->clip, x2, y1)) {
-        mvwadd_wch(ctx->win, y1, x2, chars.ur);
+        draw_wch(ctx, y1, x2, chars.ur);
     }
     if (tui_cell_rect_contains(ctx->clip, x1, y2)) {
-        mvwadd_wch(ctx->win, y2, x1, chars.ll);
+        draw_wch(ctx, y2, x1, chars.ll);
     }
     if (tui_cell_rect_contains(ctx->clip, x2, y2)) {
-        mvwadd_wch(ctx->win, y2, x2, chars.lr);
+        draw_wch(ctx, y2, x2, chars.lr);
     }
 
     /* Top edge */
     for (int col = x1 + 1; col < x2; col++) {
         if (tui_cell_rect_contains(ctx->clip, col, y1)) {
-            mvwadd_wch(ctx->win, y1, col, chars.hline);
+            draw_wch(ctx, y1, col, chars.hline);
         }
     }
 
     /* Bottom edge */
     for (int col = x1 + 1; col < x2; col++) {
         if (tui_cell_rect_contains(ctx->clip, col, y2)) {
-            mvwadd_wch(ctx->win, y2, col, chars.hline);
+            draw_wch(ctx, y2, col, chars.hline);
         }
     }
 
     /* Left edge */
     for (int row = y1 + 1; row < y2; row++) {
         if (tui_cell_rect_contains(ctx->clip, x1, row)) {
-            mvwadd_wch(ctx->win, row, x1, chars.vline);
+            draw_wch(ctx, row, x1, chars.vline);
         }
     }
 
     /* Right edge */
     for (int row = y1 + 1; row < y2; row++) {
         if (tui_cell_rect_contains(ctx->clip, x2, row)) {
-            mvwadd_wch(ctx->win, row, x2, chars.vline);
+            draw_wch(ctx, row, x2, chars.vline);
         }
     }
 }
@@ -240,6 +365,14 @@ void tui_draw_border_rect(TUI_DrawContext* ctx, TUI_CellRect rect,
 void tui_draw_hline(TUI_DrawContext* ctx, int x, int y, int length,
                      TUI_BorderStyle border_style, TUI_Style style) {
     if (length <= 0) return;
+    if (ctx->list) {
+        tui_draw_list_record(ctx, &(TUI_DrawCmd){
+            .op = TUI_DRAW_OP_HLINE,
+            .rect = (TUI_CellRect){ x, y, length, 1 },
+            .border_style = (uint8_t)border_style, .style = style
+        }, NULL);
+        return;
+    }
 
     /* Clip vertically: if row is outside clip region, nothing to draw */
     if (y < ctx->clip.y || y >= ctx->clip.y + ctx->clip.h) return;
@@ -253,13 +386,21 @@ void tui_draw_hline(TUI_DrawContext* ctx, int x, int y, int length,
     if (visible_len <= 0) return;
 
     TUI_BorderChars chars = tui_border_chars_get(border_style);
-    tui_style_apply(ctx->win, style);
-    mvwhline_set(ctx->win, y, left, chars.hline, visible_len);
+    draw_style(ctx, style);
+    draw_hline_set(ctx, y, left, chars.hline, visible_len);
 }
 
 void tui_draw_vline(TUI_DrawContext* ctx, int x, int y, int length,
                      TUI_BorderStyle border_style, TUI_Style style) {
     if (length <= 0) return;
+    if (ctx->list) {
+        tui_draw_list_record(ctx, &(TUI_DrawCmd){
+            .op = TUI_DRAW_OP_VLINE,
+            .rect = (TUI_CellRect){ x, y, 1, length },
+            .border_style = (uint8_t)border_style, .style = style
+        }, NULL);
+        return;
+    }
 
     /* Clip horizontally: if column is outside clip region, nothing to draw */
     if (x < ctx->clip.x || x >= ctx->clip.x + ctx->clip.w) return;
@@ -273,8 +414,8 @@ void tui_draw_vline(TUI_DrawContext* ctx, int x, int y, int length,
     if (visible_len <= 0) return;
 
     TUI_BorderChars chars = tui_border_chars_get(border_style);
-    tui_style_apply(ctx->win, style);
-    mvwvline_set(ctx->win, top, x, chars.vline, visible_len);
+    draw_style(ctx, style);
+    draw_vline_set(ctx, top, x, chars.vline, visible_len);
 }
 
 /* ============================================================================
@@ -297,9 +438,16 @@ void tui_draw_border(TUI_DrawContext* ctx, TUI_CellRect rect,
     if (rect.w < 2 || rect.h < 2) return;
     if (sides == 0) return;
     if (border_style == TUI_BORDER_NONE) return;
+    if (ctx->list) {
+        tui_draw_list_record(ctx, &(TUI_DrawCmd){
+            .op = TUI_DRAW_OP_BORDER, .rect = rect, .sides = sides,
+            .border_style = (uint8_t)border_style, .style = style
+        }, NULL);
+        return;
+    }
 
     TUI_BorderChars chars = tui_border_chars_get(border_style);
-    tui_style_apply(ctx->win, style);
+    draw_style(ctx, style);
 
     /* Corner positions */
     int ul_x = rect.x;
@@ -314,60 +462,60 @@ void tui_draw_border(TUI_DrawContext* ctx, TUI_CellRect rect,
     /* Upper-left corner */
     if ((sides & TUI_SIDE_TOP) && (sides & TUI_SIDE_LEFT)) {
         if (tui_cell_rect_contains(ctx->clip, ul_x, ul_y)) {
-            mvwadd_wch(ctx->win, ul_y, ul_x, chars.ul);
+            draw_wch(ctx, ul_y, ul_x, chars.ul);
         }
     } else if (sides & TUI_SIDE_TOP) {
         if (tui_cell_rect_contains(ctx->clip, ul_x, ul_y)) {
-            mvwadd_wch(ctx->win, ul_y, ul_x, chars.hline);
+            draw_wch(ctx, ul_y, ul_x, chars.hline);
         }
     } else if (sides & TUI_SIDE_LEFT) {
         if (tui_cell_rect_contains(ctx->clip, ul_x, ul_y)) {
-            mvwadd_wch(ctx->win, ul_y, ul_x, chars.vline);
+            draw_wch(ctx, ul_y, ul_x, chars.vline);
         }
     }
 
     /* Upper-right corner */
     if ((sides & TUI_SIDE_TOP) && (sides & TUI_SIDE_RIGHT)) {
         if (tui_cell_rect_contains(ctx->clip, ur_x, ur_y)) {
-            mvwadd_wch(ctx->win, ur_y, ur_x, chars.ur);
+            draw_wch(ctx, ur_y, ur_x, chars.ur);
         }
     } else if (sides & TUI_SIDE_TOP) {
         if (tui_cell_rect_contains(ctx->clip, ur_x, ur_y)) {
-            mvwadd_wch(ctx->win, ur_y, ur_x, chars.hline);
+            draw_wch(ctx, ur_y, ur_x, chars.hline);
         }
     } else if (sides & TUI_SIDE_RIGHT) {
         if (tui_cell_rect_contains(ctx->clip, ur_x, ur_y)) {
-            mvwadd_wch(ctx->win, ur_y, ur_x, chars.vline);
+            draw_wch(ctx, ur_y, ur_x, chars.vline);
         }
     }
 
     /* Lower-left corner */
     if ((sides & TUI_SIDE_BOTTOM) && (sides & TUI_SIDE_LEFT)) {
         if (tui_cell_rect_contains(ctx->clip, ll_x, ll_y)) {
-            mvwadd_wch(ctx->win, ll_y, ll_x, chars.ll);
+            draw_wch(ctx, ll_y, ll_x, chars.ll);
         }
     } else if (sides & TUI_SIDE_BOTTOM) {
         if (tui_cell_rect_contains(ctx->clip, ll_x, ll_y)) {
-            mvwadd_wch(ctx->win, ll_y, ll_x, chars.hline);
+            draw_wch(ctx, ll_y, ll_x, chars.hline);
         }
     } else if (sides & TUI_SIDE_LEFT) {
         if (tui_cell_rect_contains(ctx->clip, ll_x, ll_y)) {
-            mvwadd_wch(ctx->win, ll_y, ll_x, chars.vline);
+            draw_wch(ctx, ll_y, ll_x, chars.vline);
         }
     }
 
     /* Lower-right corner */
     if ((sides & TUI_SIDE_BOTTOM) && (sides & TUI_SIDE_RIGHT)) {
         if (tui_cell_rect_contains(ctx->clip, lr_x, lr_y)) {
-            mvwadd_wch(ctx->win, lr_y, lr_x, chars.lr);
+            draw_wch(ctx, lr_y, lr_x, chars.lr);
         }
     } else if (sides & TUI_SIDE_BOTTOM) {
         if (tui_cell_rect_contains(ctx->clip, lr_x, lr_y)) {
-            mvwadd_wch(ctx->win, lr_y, lr_x, chars.hline);
+            draw_wch(ctx, lr_y, lr_x, chars.hline);
         }
     } else if (sides & TUI_SIDE_RIGHT) {
         if (tui_cell_rect_contains(ctx->clip, lr_x, lr_y)) {
-            mvwadd_wch(ctx->win, lr_y, lr_x, chars.vline);
+            draw_wch(ctx, lr_y, lr_x, chars.vline);
         }
     }
 
@@ -375,7 +523,7 @@ void tui_draw_border(TUI_DrawContext* ctx, TUI_CellRect rect,
     if (sides & TUI_SIDE_TOP) {
         for (int col = rect.x + 1; col <= rect.x + rect.w - 2; col++) {
             if (tui_cell_rect_contains(ctx->clip, col, rect.y)) {
-                mvwadd_wch(ctx->win, rect.y, col, chars.hline);
+                draw_wch(ctx, rect.y, col, chars.hline);
             }
         }
     }
@@ -385,7 +533,7 @@ void tui_draw_border(TUI_DrawContext* ctx, TUI_CellRect rect,
         int bottom_y = rect.y + rect.h - 1;
         for (int col = rect.x + 1; col <= rect.x + rect.w - 2; col++) {
             if (tui_cell_rect_contains(ctx->clip, col, bottom_y)) {
-                mvwadd_wch(ctx->win, bottom_y, col, chars.hline);
+                draw_wch(ctx, bottom_y, col, chars.hline);
             }
         }
     }
@@ -394,7 +542,7 @@ void tui_draw_border(TUI_DrawContext* ctx, TUI_CellRect rect,
     if (sides & TUI_SIDE_LEFT) {
         for (int row = rect.y + 1; row <= rect.y + rect.h - 2; row++) {
             if (tui_cell_rect_contains(ctx->clip, rect.x, row)) {
-                mvwadd_wch(ctx->win, row, rect.x, chars.vline);
+                draw_wch(ctx, row, rect.x, chars.vline);
             }
         }
     }
@@ -404,7 +552,7 @@ void tui_draw_border(TUI_DrawContext* ctx, TUI_CellRect rect,
         int right_x = rect.x + rect.w - 1;
         for (int row = rect.y + 1; row <= rect.y + rect.h - 2; row++) {
             if (tui_cell_rect_contains(ctx->clip, right_x, row)) {
-                mvwadd_wch(ctx->win, row, right_x, chars.vline);
+                draw_wch(ctx, row, right_x, chars.vline);
             }
         }
     }
@@ -426,6 +574,13 @@ void tui_draw_border(TUI_DrawContext* ctx, TUI_CellRect rect,
 void tui_draw_text(TUI_DrawContext* ctx, int x, int y,
                     const char* text, TUI_Style style) {
     if (text == NULL) return;
+    if (ctx->list) {
+        tui_draw_list_record(ctx, &(TUI_DrawCmd){
+            .op = TUI_DRAW_OP_TEXT,
+            .rect = (TUI_CellRect){ x, y, 0, 1 }, .style = style
+        }, text);
+        return;
+    }
 
     /* Clip vertically: row must be within clip region */
     if (y < ctx->clip.y || y >= ctx->clip.y + ctx->clip.h) return;
@@ -498,8 +653,8 @@ void tui_draw_text(TUI_DrawContext* ctx, int x, int y,
     }
 
     /* Render the visible slice */
-    tui_style_apply(ctx->win, style);
-    mvwaddnwstr(ctx->win, y, draw_x, &wbuf[start_idx], end_idx - start_idx);
+    draw_style(ctx, style);
+    draw_wstr(ctx, y, draw_x, &wbuf[start_idx], end_idx - start_idx);
 
     if (wbuf != wbuf_stack) free(wbuf);
 }
@@ -589,8 +744,8 @@ static void subcell_write_halfblock(TUI_DrawContext* ctx,
 
     cchar_t cc;
     setcchar(&cc, wc, A_NORMAL, 0, NULL);
-    tui_style_apply(ctx->win, style);
-    mvwadd_wch(ctx->win, cell_y, cell_x, &cc);
+    draw_style(ctx, style);
+    draw_wch(ctx, cell_y, cell_x, &cc);
 }
 
 /* ----------------------------------------------------------------------------
@@ -601,6 +756,14 @@ static void subcell_write_halfblock(TUI_DrawContext* ctx,
  * --------------------------------------------------------------------------*/
 void tui_draw_halfblock_plot(TUI_DrawContext* ctx, int px, int py,
                               TUI_Style style) {
+    if (ctx->list) {
+        tui_draw_list_record(ctx, &(TUI_DrawCmd){
+            .op = TUI_DRAW_OP_HALFBLOCK_PLOT,
+            .rect = (TUI_CellRect){ px, py, 1, 1 }, .style = style
+        }, NULL);
+        return;
+    }
+
     TUI_SubCellBuffer* buf = subcell_ensure_buffer(ctx);
     if (!buf) return;
 
@@ -648,6 +811,13 @@ void tui_draw_halfblock_fill_rect(TUI_DrawContext* ctx,
                                    int px, int py, int pw, int ph,
                                    TUI_Style style) {
     if (pw <= 0 || ph <= 0) return;
+    if (ctx->list) {
+        tui_draw_list_record(ctx, &(TUI_DrawCmd){
+            .op = TUI_DRAW_OP_HALFBLOCK_FILL,
+            .rect = (TUI_CellRect){ px, py, pw, ph }, .style = style
+        }, NULL);
+        return;
+    }
 
     TUI_SubCellBuffer* buf = subcell_ensure_buffer(ctx);
     if (!buf) return;
@@ -776,8 +946,8 @@ static void subcell_write_quadrant(TUI_DrawContext* ctx,
 
     cchar_t cc;
     setcchar(&cc, wc, A_NORMAL, 0, NULL);
-    tui_style_apply(ctx->win, style);
-    mvwadd_wch(ctx->win, cell_y, cell_x, &cc);
+    draw_style(ctx, style);
+    draw_wch(ctx, cell_y, cell_x, &cc);
 }
 
 /* ----------------------------------------------------------------------------
@@ -789,6 +959,14 @@ static void subcell_write_quadrant(TUI_DrawContext* ctx,
  * --------------------------------------------------------------------------*/
 void tui_draw_quadrant_plot(TUI_DrawContext* ctx, int px, int py,
                               TUI_Style style) {
+    if (ctx->list) {
+        tui_draw_list_record(ctx, &(TUI_DrawCmd){
+            .op = TUI_DRAW_OP_QUADRANT_PLOT,
+            .rect = (TUI_CellRect){ px, py, 1, 1 }, .style = style
+        }, NULL);
+        return;
+    }
+
     TUI_SubCellBuffer* buf = subcell_ensure_buffer(ctx);
     if (!buf) return;
 
@@ -834,6 +1012,13 @@ void tui_draw_quadrant_fill_rect(TUI_DrawContext* ctx,
                                    int px, int py, int pw, int ph,
                                    TUI_Style style) {
     if (pw <= 0 || ph <= 0) return;
+    if (ctx->list) {
+        tui_draw_list_record(ctx, &(TUI_DrawCmd){
+            .op = TUI_DRAW_OP_QUADRANT_FILL,
+            .rect = (TUI_CellRect){ px, py, pw, ph }, .style = style
+        }, NULL);
+        return;
+    }
 
     TUI_SubCellBuffer* buf = subcell_ensure_buffer(ctx);
     if (!buf) return;
@@ -933,8 +1118,8 @@ static void subcell_write_braille(TUI_DrawContext* ctx,
 
     cchar_t cc;
     setcchar(&cc, wc, A_NORMAL, 0, NULL);
-    tui_style_apply(ctx->win, style);
-    mvwadd_wch(ctx->win, cell_y, cell_x, &cc);
+    draw_style(ctx, style);
+    draw_wch(ctx, cell_y, cell_x, &cc);
 }
 
 /* ----------------------------------------------------------------------------
@@ -946,6 +1131,14 @@ static void subcell_write_braille(TUI_DrawContext* ctx,
  * --------------------------------------------------------------------------*/
 void tui_draw_braille_plot(TUI_DrawContext* ctx, int px, int py,
                              TUI_Style style) {
+    if (ctx->list) {
+        tui_draw_list_record(ctx, &(TUI_DrawCmd){
+            .op = TUI_DRAW_OP_BRAILLE_PLOT,
+            .rect = (TUI_CellRect){ px, py, 1, 1 }, .style = style
+        }, NULL);
+        return;
+    }
+
     TUI_SubCellBuffer* buf = subcell_ensure_buffer(ctx);
     if (!buf) return;
 
@@ -986,6 +1179,14 @@ void tui_draw_braille_plot(TUI_DrawContext* ctx, int px, int py,
  * No-op if cell is not in braille mode.
  * --------------------------------------------------------------------------*/
 void tui_draw_braille_unplot(TUI_DrawContext* ctx, int px, int py) {
+    if (ctx->list) {
+        tui_draw_list_record(ctx, &(TUI_DrawCmd){
+            .op = TUI_DRAW_OP_BRAILLE_UNPLOT,
+            .rect = (TUI_CellRect){ px, py, 1, 1 }
+        }, NULL);
+        return;
+    }
+
     if (!ctx->subcell_buf) return;    /* non-layer context */
     if (!*ctx->subcell_buf) return;   /* no buffer allocated, nothing to unplot */
 
@@ -1026,6 +1227,13 @@ void tui_draw_braille_fill_rect(TUI_DrawContext* ctx,
                                   int px, int py, int pw, int ph,
                                   TUI_Style style) {
     if (pw <= 0 || ph <= 0) return;
+    if (ctx->list) {
+        tui_draw_list_record(ctx, &(TUI_DrawCmd){
+            .op = TUI_DRAW_OP_BRAILLE_FILL,
+            .rect = (TUI_CellRect){ px, py, pw, ph }, .style = style
+        }, NULL);
+        return;
+    }
 
     TUI_SubCellBuffer* buf = subcell_ensure_buffer(ctx);
     if (!buf) return;
@@ -0,0 +1,352 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * TUI Draw List - Recorded draw commands with replay and culling
+ *
+ * Implements the display-list layer over the tui_draw_* primitives. While
+ * a context has ctx->list set, the primitives call tui_draw_list_record()
+ * instead of touching ncurses. tui_draw_list_replay() later re-issues the
+ * surviving commands through the same primitives against the real WINDOW.
+ *
+ * Culling:
+ *   - Record time: commands whose cell bounds do not intersect ctx->clip
+ *     are dropped.
+ *   - Replay time: cell commands fully covered by a LATER fill_rect (which
+ *     writes every cell of rect ∩ clip) are skipped. Sub-cell commands are
+ *     always replayed -- they mutate the shadow buffer that later sub-cell
+ *     draws read back.
+ *
+ * Change detection: a 64-bit FNV-1a hash is folded in as commands are
+ * recorded. tui_draw_list_changed() compares it with the hash of the last
+ * replay in O(1), so unchanged surfaces skip replay entirely.
+ *
+ * Command and text arenas grow geometrically and are reused across frames.
+ */
+
+#include <cels_ncurses_draw.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DRAW_LIST_INITIAL_CMDS 64
+#define DRAW_LIST_INITIAL_TEXT 1024
+#define DRAW_LIST_COVER_MAX    8      /* Fill rects tracked by the overdraw pass */
+
+#define FNV64_OFFSET 0xcbf29ce484222325ULL
+#define FNV64_PRIME  0x100000001b3ULL
+
+/* ============================================================================
+ * Hashing
+ * ============================================================================ */
+
+static uint64_t fnv_mix(uint64_t h, const void* data, size_t len) {
+    const unsigned char* p = data;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= FNV64_PRIME;
+    }
+    return h;
+}
+
+static uint64_t fnv_mix_int(uint64_t h, int v) {
+    return fnv_mix(h, &v, sizeof(v));
+}
+
+/* Field-by-field so struct padding never leaks into the hash */
+static uint64_t hash_cmd(uint64_t h, const TUI_DrawCmd* c) {
+    h = fnv_mix_int(h, c->op);
+    h = fnv_mix_int(h, c->border_style);
+    h = fnv_mix_int(h, c->sides);
+    h = fnv_mix(h, &c->rect, sizeof(c->rect));
+    h = fnv_mix(h, &c->clip, sizeof(c->clip));
+    h = fnv_mix_int(h, c->style.fg.index);
+    h = fnv_mix_int(h, c->style.bg.index);
+    h = fnv_mix(h, &c->style.attrs, sizeof(c->style.attrs));
+    h = fnv_mix(h, &c->fill_ch, sizeof(c->fill_ch));
+    return h;
+}
+
+/* ============================================================================
+ * Command Bounds
+ * ============================================================================
+ *
+ * Conservative cell-space bounding rect of everything a command may write.
+ * Sub-cell ops divide by the mode's pixels-per-cell using the same integer
+ * division as the immediate-mode primitives.
+ */
+
+static bool cmd_is_subcell(uint8_t op) {
+    return op >= TUI_DRAW_OP_HALFBLOCK_PLOT;
+}
+
+static TUI_CellRect subcell_bounds(TUI_CellRect r, int sx, int sy) {
+    int x0 = r.x / sx;
+    int y0 = r.y / sy;
+    int x1 = (r.x + r.w - 1) / sx;
+    int y1 = (r.y + r.h - 1) / sy;
+    return (TUI_CellRect){ x0, y0, x1 - x0 + 1, y1 - y0 + 1 };
+}
+
+static TUI_CellRect cmd_bounds(const TUI_DrawCmd* c) {
+    TUI_CellRect r = c->rect;
+    switch (c->op) {
+        case TUI_DRAW_OP_TEXT:
+            /* Width unknown without decoding: extend to the clip's right edge */
+            r.w = c->clip.x + c->clip.w - r.x;
+            r.h = 1;
+            return r;
+        case TUI_DRAW_OP_HALFBLOCK_PLOT:
+        case TUI_DRAW_OP_HALFBLOCK_FILL:
+            return subcell_bounds(r, 1, 2);
+        case TUI_DRAW_OP_QUADRANT_PLOT:
+        case TUI_DRAW_OP_QUADRANT_FILL:
+            return subcell_bounds(r, 2, 2);
+        case TUI_DRAW_OP_BRAILLE_PLOT:
+        case TUI_DRAW_OP_BRAILLE_UNPLOT:
+        case TUI_DRAW_OP_BRAILLE_FILL:
+            return subcell_bounds(r, 2, 4);
+        default:
+            return r;
+    }
+}
+
+static bool rect_empty(TUI_CellRect r) {
+    return r.w <= 0 || r.h <= 0;
+}
+
+static bool rect_covers(TUI_CellRect outer, TUI_CellRect inner) {
+    return inner.x >= outer.x && inner.y >= outer.y &&
+           inner.x + inner.w <= outer.x + outer.w &&
+           inner.y + inner.h <= outer.y + outer.h;
+}
+
+/* ============================================================================
+ * Lifecycle
+ * ============================================================================ */
+
+TUI_DrawList* tui_draw_list_create(void) {
+    TUI_DrawList* list = calloc(1, sizeof(TUI_DrawList));
+    if (!list) return NULL;
+    list->hash = FNV64_OFFSET;
+    return list;
+}
+
+void tui_draw_list_destroy(TUI_DrawList* list) {
+    if (!list) return;
+    free(list->cmds);
+    free(list->text);
+    free(list->scratch);
+    free(list);
+}
+
+void tui_draw_list_begin(TUI_DrawList* list) {
+    if (!list) return;
+    list->count = 0;
+    list->text_len = 0;
+    list->culled = 0;
+    list->hash = FNV64_OFFSET;
+}
+
+void tui_draw_list_invalidate(TUI_DrawList* list) {
+    if (!list) return;
+    list->has_last = false;
+}
+
+bool tui_draw_list_changed(const TUI_DrawList* list) {
+    if (!list) return false;
+    return !list->has_last || list->hash != list->last_hash;
+}
+
+/* ============================================================================
+ * Recording
+ * ============================================================================ */
+
+static bool ensure_cmd_capacity(TUI_DrawList* list) {
+    if (list->count < list->capacity) return true;
+    int cap = list->capacity ? list->capacity * 2 : DRAW_LIST_INITIAL_CMDS;
+    TUI_DrawCmd* cmds = realloc(list->cmds, (size_t)cap * sizeof(TUI_DrawCmd));
+    if (!cmds) return false;
+    list->cmds = cmds;
+    list->capacity = cap;
+    return true;
+}
+
+static bool ensure_text_capacity(TUI_DrawList* list, uint32_t extra) {
+    if (list->text_len + extra <= list->text_cap) return true;
+    uint32_t cap = list->text_cap ? list->text_cap : DRAW_LIST_INITIAL_TEXT;
+    while (cap < list->text_len + extra) cap *= 2;
+    char* text = realloc(list->text, cap);
+    if (!text) return false;
+    list->text = text;
+    list->text_cap = cap;
+    return true;
+}
+
+bool tui_draw_list_record(TUI_DrawContext* ctx, const TUI_DrawCmd* cmd,
+                           const char* text) {
+    TUI_DrawList* list = ctx->list;
+    if (!list) return false;
+
+    TUI_DrawCmd c = *cmd;
+    c.clip = ctx->clip;
+
+    /* Record-time cull: nothing of this command can land inside the clip */
+    if (rect_empty(tui_cell_rect_intersect(cmd_bounds(&c), c.clip))) {
+        list->culled++;
+        return true;
+    }
+
+    if (!ensure_cmd_capacity(list)) return false;
+
+    c.text_off = 0;
+    c.text_len = 0;
+    if (text) {
+        size_t len = strlen(text);
+        if (!ensure_text_capacity(list, (uint32_t)len + 1)) return false;
+        memcpy(list->text + list->text_len, text, len + 1);
+        c.text_off = list->text_len;
+        c.text_len = (uint32_t)len;
+        list->text_len += (uint32_t)len + 1;
+        list->hash = fnv_mix(list->hash, text, len + 1);
+    }
+
+    list->hash = hash_cmd(list->hash, &c);
+    list->cmds[list->count++] = c;
+    return true;
+}
+
+/* ============================================================================
+ * Replay
+ * ============================================================================ */
+
+/* True if cmd is completely hidden by one of the cover rects */
+static bool cmd_overdrawn(const TUI_DrawCmd* c, const TUI_CellRect* cover, int n) {
+    TUI_CellRect vis = tui_cell_rect_intersect(cmd_bounds(c), c->clip);
+    for (int k = 0; k < n; k++) {
+        if (rect_covers(cover[k], vis)) return true;
+    }
+    return false;
+}
+
+/* Add a fill's visible rect to the cover set. Once full, a larger rect
+ * replaces the smallest one: big fills (backgrounds, panels) hide the most. */
+static void cover_add(TUI_CellRect* cover, int* n, TUI_CellRect r) {
+    if (rect_empty(r)) return;
+    if (*n < DRAW_LIST_COVER_MAX) {
+        cover[(*n)++] = r;
+        return;
+    }
+    int smallest = 0;
+    for (int k = 1; k < *n; k++) {
+        if (cover[k].w * cover[k].h < cover[smallest].w * cover[smallest].h) smallest = k;
+    }
+    if (r.w * r.h > cover[smallest].w * cover[smallest].h) cover[smallest] = r;
+}
+
+static void replay_cmd(TUI_DrawContext* ctx, const TUI_DrawList* list,
+                       const TUI_DrawCmd* c) {
+    TUI_CellRect r = c->rect;
+    TUI_BorderStyle bs = (TUI_BorderStyle)c->border_style;
+
+    switch (c->op) {
+        case TUI_DRAW_OP_FILL_RECT:
+            tui_draw_fill_rect(ctx, r, c->fill_ch, c->style);
+            break;
+        case TUI_DRAW_OP_BORDER_RECT:
+            tui_draw_border_rect(ctx, r, bs, c->style);
+            break;
+        case TUI_DRAW_OP_BORDER:
+            tui_draw_border(ctx, r, c->sides, bs, c->style);
+            break;
+        case TUI_DRAW_OP_TEXT:
+            tui_draw_text(ctx, r.x, r.y, list->text + c->text_off, c->style);
+            break;
+        case TUI_DRAW_OP_HLINE:
+            tui_draw_hline(ctx, r.x, r.y, r.w, bs, c->style);
+            break;
+        case TUI_DRAW_OP_VLINE:
+            tui_draw_vline(ctx, r.x, r.y, r.h, bs, c->style);
+            break;
+        case TUI_DRAW_OP_HALFBLOCK_PLOT:
+            tui_draw_halfblock_plot(ctx, r.x, r.y, c->style);
+            break;
+        case TUI_DRAW_OP_HALFBLOCK_FILL:
+            tui_draw_halfblock_fill_rect(ctx, r.x, r.y, r.w, r.h, c->style);
+            break;
+        case TUI_DRAW_OP_QUADRANT_PLOT:
+            tui_draw_quadrant_plot(ctx, r.x, r.y, c->style);
+            break;
+        case TUI_DRAW_OP_QUADRANT_FILL:
+            tui_draw_quadrant_fill_rect(ctx, r.x, r.y, r.w, r.h, c->style);
+            break;
+        case TUI_DRAW_OP_BRAILLE_PLOT:
+            tui_draw_braille_plot(ctx, r.x, r.y, c->style);
+            break;
+        case TUI_DRAW_OP_BRAILLE_UNPLOT:
+            tui_draw_braille_unplot(ctx, r.x, r.y);
+            break;
+        case TUI_DRAW_OP_BRAILLE_FILL:
+            tui_draw_braille_fill_rect(ctx, r.x, r.y, r.w, r.h, c->style);
+            break;
+        default:
+            break;
+    }
+}
+
+void tui_draw_list_replay(TUI_DrawList* list, TUI_DrawContext* target) {
+    if (!list || !target) return;
+
+    /* Mark overdrawn commands in one backward pass, carrying the fills seen
+     * so far (i.e. drawn later) as the cover set */
+    if (list->scratch_cap < list->count) {
+        int* scratch = realloc(list->scratch, (size_t)list->count * sizeof(int));
+        if (scratch) {
+            list->scratch = scratch;
+            list->scratch_cap = list->count;
+        }
+    }
+    bool marked = list->scratch_cap >= list->count;
+    if (marked) {
+        TUI_CellRect cover[DRAW_LIST_COVER_MAX];
+        int ncover = 0;
+        for (int i = list->count - 1; i >= 0; i--) {
+            const TUI_DrawCmd* c = &list->cmds[i];
+            bool hidden = !cmd_is_subcell(c->op) && cmd_overdrawn(c, cover, ncover);
+            list->scratch[i] = hidden;
+            if (!hidden && c->op == TUI_DRAW_OP_FILL_RECT) {
+                cover_add(cover, &ncover, tui_cell_rect_intersect(c->rect, c->clip));
+            }
+        }
+    }
+
+    /* Replay through the immediate-mode primitives */
+    TUI_DrawContext ctx = *target;
+    ctx.list = NULL;
+
+    for (int i = 0; i < list->count; i++) {
+        if (marked && list->scratch[i]) {
+            list->culled++;
+            continue;
+        }
+        const TUI_DrawCmd* c = &list->cmds[i];
+        ctx.clip = c->clip;
+        replay_cmd(&ctx, list, c);
+    }
+
+    list->last_hash = list->hash;
+    list->has_last = true;
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * TUI Render Pool - Parallel draw callbacks for off-screen surfaces
+ *
+ * A small pthread pool started on first use. tui_render_parallel() publishes
+ * a batch (jobs array + counters) under g_pool_lock, bumps the generation
+ * and wakes the workers; workers and the caller then claim jobs one at a
+ * time until none are left. Batches are a handful of surfaces per frame, so
+ * one lock per claimed job is cheap next to the draw work itself.
+ *
+ * Jobs without ctx->cells would call ncurses and are never handed to a
+ * worker: they are skipped during the batch and run on the caller after it.
+ */
+
+#include <cels_ncurses_draw.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+static pthread_mutex_t g_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_pool_work = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t g_pool_done = PTHREAD_COND_INITIALIZER;
+
+static pthread_t g_workers[TUI_RENDER_MAX_WORKERS];
+static int g_worker_count = -1;     /* -1 = not started */
+static bool g_pool_stop = false;
+
+static TUI_RenderJob* g_jobs = NULL;
+static int g_job_count = 0;
+static int g_next_job = 0;
+static int g_jobs_left = 0;
+static unsigned g_generation = 0;
+
+/* Claim and run jobs of the current batch. Called with g_pool_lock held;
+ * the lock is dropped around each callback. */
+static void run_jobs_locked(void) {
+    while (g_next_job < g_job_count) {
+        TUI_RenderJob* job = &g_jobs[g_next_job++];
+        if (job->ctx && job->ctx->cells && job->fn) {
+            pthread_mutex_unlock(&g_pool_lock);
+            job->fn(job->ctx, job->user);
+            pthread_mutex_lock(&g_pool_lock);
+        }
+        if (--g_jobs_left == 0) {
+            pthread_cond_broadcast(&g_pool_done);
+        }
+    }
+}
+
+static void* render_worker(void* arg) {
+    (void)arg;
+    unsigned seen = 0;
+
+    pthread_mutex_lock(&g_pool_lock);
+    for (;;) {
+        while (!g_pool_stop && g_generation == seen) {
+            pthread_cond_wait(&g_pool_work, &g_pool_lock);
+        }
+        if (g_pool_stop) break;
+        seen = g_generation;
+        run_jobs_locked();
+    }
+    pthread_mutex_unlock(&g_pool_lock);
+    return NULL;
+}
+
+/* Start workers on first use. Called with g_pool_lock held. */
+static void pool_start_locked(void) {
+    if (g_worker_count >= 0) return;
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int wanted = (cpus > 1) ? (int)(cpus - 1) : 0;
+    if (wanted > TUI_RENDER_MAX_WORKERS) wanted = TUI_RENDER_MAX_WORKERS;
+
+    g_pool_stop = false;
+    g_worker_count = 0;
+    for (int i = 0; i < wanted; i++) {
+        if (pthread_create(&g_workers[i], NULL, render_worker, NULL) != 0) break;
+        g_worker_count++;
+    }
+}
+
+void tui_render_parallel(TUI_RenderJob* jobs, int count) {
+    if (!jobs || count <= 0) return;
+
+    /* Warm lazily initialized draw tables before other threads read them */
+    (void)tui_border_chars_get(TUI_BORDER_ROUNDED);
+
+    pthread_mutex_lock(&g_pool_lock);
+    pool_start_locked();
+
+    g_jobs = jobs;
+    g_job_count = count;
+    g_next_job = 0;
+    g_jobs_left = count;
+    g_generation++;
+    pthread_cond_broadcast(&g_pool_work);
+
+    run_jobs_locked();
+    while (g_jobs_left > 0) {
+        pthread_cond_wait(&g_pool_done, &g_pool_lock);
+    }
+
+    g_jobs = NULL;
+    g_job_count = 0;
+    g_next_job = 0;
+    pthread_mutex_unlock(&g_pool_lock);
+
+    /* Jobs that draw into a WINDOW stay on the ncurses thread */
+    for (int i = 0; i < count; i++) {
+        if (jobs[i].ctx && !jobs[i].ctx->cells && jobs[i].fn) {
+            jobs[i].fn(jobs[i].ctx, jobs[i].user);
+        }
+    }
+}
+
+void tui_render_pool_shutdown(void) {
+    pthread_mutex_lock(&g_pool_lock);
+    if (g_worker_count <= 0) {
+        g_worker_count = -1;
+        pthread_mutex_unlock(&g_pool_lock);
+        return;
+    }
+    g_pool_stop = true;
+    pthread_cond_broadcast(&g_pool_work);
+    int count = g_worker_count;
+    pthread_mutex_unlock(&g_pool_lock);
+
+    for (int i = 0; i < count; i++) {
+        pthread_join(g_workers[i], NULL);
+    }
+
+    pthread_mutex_lock(&g_pool_lock);
+    g_worker_count = -1;
+    g_pool_stop = false;
+    pthread_mutex_unlock(&g_pool_lock);
+}
@@ -22,27 +22,16 @@
  * the previous clip. Reset clears the stack and initializes the base clip
  * to the full drawable area from the draw context.
  *
+ * The stack lives in the draw context itself (ctx->scissor), so there is
+ * no shared state: interleaved push/pop on two surfaces cannot corrupt
+ * each other, and separate contexts may be driven from separate threads.
+ *
  * ctx->clip is updated on every push, pop, and reset so draw functions
  * always see the current effective clip region.
- *
- * NOTE: This file compiles in the CONSUMER's context (INTERFACE library).
- * Static variables are per-consumer translation unit.
  */
 
 #include <cels_ncurses_draw.h>
 
-/* ============================================================================
- * Static State
- * ============================================================================
- *
- * The scissor stack is a fixed-size array with a stack pointer.
- * g_scissor_stack[0] is always the base clip (full drawable area).
- * g_scissor_sp indexes the current top of stack.
- */
-
-static TUI_CellRect g_scissor_stack[TUI_SCISSOR_STACK_MAX];
-static int g_scissor_sp = 0;
-
 /* ============================================================================
  * Scissor Stack API
  * ============================================================================ */
@@ -52,11 +41,12 @@ static int g_scissor_sp = 0;
  * Call once per frame before any push/pop operations.
  */
 void tui_scissor_reset(TUI_DrawContext* ctx) {
-    g_scissor_stack[0] = (TUI_CellRect){
+    TUI_ScissorStack* st = &ctx->scissor;
+    st->rects[0] = (TUI_CellRect){
         ctx->x, ctx->y, ctx->width, ctx->height
     };
-    g_scissor_sp = 0;
-    ctx->clip = g_scissor_stack[0];
+    st->sp = 0;
+    ctx->clip = st->rects[0];
 }
 
 /*
@@ -66,12 +56,12 @@ void tui_scissor_reset(TUI_DrawContext* ctx) {
  * is silently ignored.
  */
 void tui_push_scissor(TUI_DrawContext* ctx, TUI_CellRect rect) {
-    if (g_scissor_sp >= TUI_SCISSOR_STACK_MAX - 1) return;
+    TUI_ScissorStack* st = &ctx->scissor;
+    if (st->sp >= TUI_SCISSOR_STACK_MAX - 1) return;
 
-    TUI_CellRect clipped = tui_cell_rect_intersect(rect,
-                                                     g_scissor_stack[g_scissor_sp]);
-    g_scissor_sp++;
-    g_scissor_stack[g_scissor_sp] = clipped;
+    TUI_CellRect clipped = tui_cell_rect_intersect(rect, st->rects[st->sp]);
+    st->sp++;
+    st->rects[st->sp] = clipped;
     ctx->clip = clipped;
 }
 
@@ -80,8 +70,9 @@ void tui_push_scissor(TUI_DrawContext* ctx, TUI_CellRect rect) {
  * If already at the base level (sp == 0), the pop is silently ignored.
  */
 void tui_pop_scissor(TUI_DrawContext* ctx) {
-    if (g_scissor_sp > 0) {
-        g_scissor_sp--;
+    TUI_ScissorStack* st = &ctx->scissor;
+    if (st->sp > 0) {
+        st->sp--;
     }
-    ctx->clip = g_scissor_stack[g_scissor_sp];
+    ctx->clip = st->rects[st->sp];
 }
@@ -41,6 +41,7 @@ TUI_SubCellBuffer* tui_subcell_buffer_create(int width, int height) {
 
     buf->width = width;
     buf->height = height;
+    buf->capacity = width * height;
     buf->cells = calloc((size_t)(width * height), sizeof(TUI_SubCell));
     if (!buf->cells) {
         free(buf);
@@ -64,25 +65,81 @@ void tui_subcell_buffer_clear(TUI_SubCellBuffer* buf) {
 }
 
 /* ============================================================================
- * tui_subcell_buffer_resize -- Reallocate for new dimensions
+ * tui_subcell_buffer_resize -- Re-stride in place for new dimensions
  * ============================================================================
  *
- * Frees the old cells array and allocates a new one at the new dimensions.
- * Content is discarded (new array is zero-initialized). Called from
- * tui_layer_resize when the layer dimensions change.
+ * Grows the cells array geometrically only when width * height exceeds
+ * capacity, then moves each kept row to its new stride: bottom-up when rows
+ * get wider (destinations lie after sources), top-down when they get
+ * narrower. Cells outside the old size are zeroed (TUI_SUBCELL_NONE).
+ * During a resize storm this is a few memmoves per frame, not an allocation.
  */
 void tui_subcell_buffer_resize(TUI_SubCellBuffer* buf, int width, int height) {
     if (!buf) return;
+    if (width < 0) width = 0;
+    if (height < 0) height = 0;
 
-    TUI_SubCell* new_cells = calloc((size_t)(width * height), sizeof(TUI_SubCell));
-    if (!new_cells) return;
+    int need = width * height;
+    if (need > buf->capacity) {
+        int cap = buf->capacity * 2;
+        if (cap < need) cap = need;
+        TUI_SubCell* grown = realloc(buf->cells, (size_t)cap * sizeof(TUI_SubCell));
+        if (!grown) return;
+        buf->cells = grown;
+        buf->capacity = cap;
+    }
+
+    int old_w = buf->width;
+    int keep_rows = height < buf->height ? height : buf->height;
+    int keep_cols = width < old_w ? width : old_w;
+    size_t cell = sizeof(TUI_SubCell);
+
+    if (width > old_w) {
+        for (int y = keep_rows - 1; y >= 0; y--) {
+            memmove(&buf->cells[y * width], &buf->cells[y * old_w], (size_t)keep_cols * cell);
+            memset(&buf->cells[y * width + keep_cols], 0, (size_t)(width - keep_cols) * cell);
+        }
+    } else if (width < old_w) {
+        for (int y = 0; y < keep_rows; y++) {
+            memmove(&buf->cells[y * width], &buf->cells[y * old_w], (size_t)keep_cols * cell);
+        }
+    }
+    if (height > keep_rows) {
+        memset(&buf->cells[keep_rows * width], 0,
+               (size_t)((height - keep_rows) * width) * cell);
+    }
 
-    free(buf->cells);
-    buf->cells = new_cells;
     buf->width = width;
     buf->height = height;
 }
 
+/* ============================================================================
+ * tui_subcell_buffer_scroll -- Shift rows for a scrolled surface
+ * ============================================================================
+ *
+ * Mirrors wscrl() on the layer's WINDOW so sub-cell state stays aligned
+ * with the glyphs it produced. Rows shifted past the edge are dropped and
+ * the exposed rows are zeroed.
+ */
+void tui_subcell_buffer_scroll(TUI_SubCellBuffer* buf, int dy) {
+    if (!buf || !buf->cells || dy == 0) return;
+    int n = dy > 0 ? dy : -dy;
+    if (n >= buf->height) {
+        tui_subcell_buffer_clear(buf);
+        return;
+    }
+
+    size_t row = (size_t)buf->width * sizeof(TUI_SubCell);
+    size_t kept = (size_t)(buf->height - n) * row;
+    if (dy > 0) {
+        memmove(buf->cells, &buf->cells[n * buf->width], kept);
+        memset(&buf->cells[(buf->height - n) * buf->width], 0, (size_t)n * row);
+    } else {
+        memmove(&buf->cells[n * buf->width], buf->cells, kept);
+        memset(buf->cells, 0, (size_t)n * row);
+    }
+}
+
 /* ============================================================================
  * tui_subcell_buffer_destroy -- Free buffer and cells
  * ============================================================================
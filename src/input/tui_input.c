@@ -26,42 +26,600 @@
  *
  * Mouse: drain loop captures all queued events per frame. Final position
  * and last button event are kept. Held state persists across frames.
+ * Any-motion tracking (1003) reports hover and drag positions, SGR (1006)
+ * reports are decoded here without a column limit, and wheel steps arrive
+ * as their own events.
  *
- * KEY_RESIZE: consumed and dropped (resize handled by NCurses_WindowUpdateSystem + TUI_SurfaceSystem).
- * F1: handled internally (pause mode for text selection/copy).
+ * KEY_RESIZE: recorded as a resize event, otherwise not acted on (resize
+ * handled by NCurses_WindowUpdateSystem + TUI_SurfaceSystem).
+ * F1: handled internally (pause mode for text selection/copy, see below).
  * All other keys go into the keys[] array for the developer to read.
+ *
+ * Every key, mouse and resize event is also appended, timestamped, to the
+ * frame's event list (NCurses_InputState.events). The list lives in one
+ * buffer that is reset each frame and grows geometrically when a frame
+ * brings more events than ever before, so steady-state frames allocate
+ * nothing and no event is dropped.
+ *
+ * Bracketed paste (CSI ?2004h) is enabled at configure time. Everything
+ * between the paste markers goes into one paste buffer instead of keys[]
+ * and arrives as a single NCURSES_EVENT_PASTE pointing at those bytes. A
+ * paste may span several frames; it is delivered in the frame that sees
+ * its end marker.
+ *
+ * With NCursesWindow(.raw_input = true) getch() is not used: bytes are read
+ * from the input fd and decoded by tui_input_parser.c (no ESCDELAY, every
+ * key with its modifiers, kitty keyboard protocol when available). Both
+ * paths feed the same key/mouse/paste handlers below. With
+ * .input_thread = true the bytes are read and decoded by
+ * tui_input_thread.c as they arrive; this system only pops its ring.
  */
 
+#define _POSIX_C_SOURCE 199309L
 #include <cels_ncurses.h>
 #include "../tui_internal.h"
 #include <ncurses.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <unistd.h>
 #include <cels/cels.h>
 
-/* Custom key codes for Ctrl+Arrow (above KEY_MAX, below INT_MAX) */
-#define CELS_KEY_CTRL_UP    600
-#define CELS_KEY_CTRL_DOWN  601
-#define CELS_KEY_CTRL_RIGHT 602
-#define CELS_KEY_CTRL_LEFT  603
-
-/* Custom key codes for Shift+Arrow (text selection support) */
-#define CELS_KEY_SHIFT_LEFT  604
-#define CELS_KEY_SHIFT_RIGHT 605
-
 /* Max keys per frame (matches NCurses_InputState.keys[16]) */
 #define MAX_KEYS_PER_FRAME 16
 
+/* Initial event buffer capacity; doubled whenever a frame outgrows it */
+#define INPUT_EVENTS_INITIAL 64
+
+/* End a paste whose end marker never came after this long without bytes
+ * (the raw parser applies the same limit) */
+#define INPUT_PASTE_TIMEOUT_NS (1000 * 1000000ull)
+
 /* CEL_State(NCurses_InputState) — owned by this TU */
 static struct NCurses_InputState NCurses_InputState = { .mouse_x = -1, .mouse_y = -1 };
 
+/* Backing store for NCurses_InputState.events (reused across frames) */
+static NCurses_InputEvent* g_events = NULL;
+static int g_event_cap = 0;
+static int g_event_count = 0;
+
+/* Motion coalescing (NCurses_WindowConfig.mouse_motion) */
+static int g_motion_mode = NCURSES_MOTION_ALL;
+static int g_last_motion = -1;      /* Event index of the last motion point */
+static int g_motion_run = 0;        /* Motion points in the current run */
+
+/* Raw input (NCurses_WindowConfig.raw_input) */
+static bool g_raw_input = false;
+static int g_input_fd = -1;
+static int g_raw_cols = 0;
+static int g_raw_lines = 0;
+
+/* Paste bytes for this frame: completed pastes back to back (each
+ * NUL-terminated) from 0 to g_paste_done, then the paste in progress */
+static char* g_paste = NULL;
+static size_t g_paste_cap = 0;
+static size_t g_paste_len = 0;
+static size_t g_paste_done = 0;
+static bool g_in_paste = false;
+static uint64_t g_paste_last_ns = 0;    /* Last paste byte (ncurses path) */
+
 /* ============================================================================
- * Pause Mode -- F1 freezes the frame loop for text selection/copy
+ * Event Queue
  * ============================================================================ */
 
-static void tui_pause(void) {
-    nodelay(stdscr, FALSE);
-    wgetch(stdscr);  /* Block until any key */
-    nodelay(stdscr, TRUE);
+static uint64_t input_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* Timestamp for new events: the arrival time of the token being handled
+ * when the input thread supplies one, else now */
+static uint64_t g_event_time = 0;
+
+static uint64_t input_event_time(void) {
+    return g_event_time ? g_event_time : input_now_ns();
+}
+
+/* Append a timestamped event of the given type. Returns NULL only if the
+ * buffer could not grow (the event is then lost). */
+static NCurses_InputEvent* input_event_push(NCurses_InputEventType type) {
+    if (g_event_count == g_event_cap) {
+        int cap = g_event_cap ? g_event_cap * 2 : INPUT_EVENTS_INITIAL;
+        NCurses_InputEvent* grown = realloc(g_events, (size_t)cap * sizeof(*grown));
+        if (!grown) return NULL;
+        g_events = grown;
+        g_event_cap = cap;
+    }
+    NCurses_InputEvent* ev = &g_events[g_event_count++];
+    memset(ev, 0, sizeof(*ev));
+    ev->type = type;
+    ev->time_ns = input_event_time();
+    return ev;
+}
+
+/* Append one byte to the paste buffer (grows by doubling) */
+static bool paste_append(char byte) {
+    if (g_paste_len == g_paste_cap) {
+        size_t cap = g_paste_cap ? g_paste_cap * 2 : 4096;
+        char* grown = realloc(g_paste, cap);
+        if (!grown) return false;
+        g_paste = grown;
+        g_paste_cap = cap;
+    }
+    g_paste[g_paste_len++] = byte;
+    return true;
+}
+
+/* ncurses matched a key sequence inside the paste: put its bytes back */
+static void paste_append_key(int ch) {
+    char* seq = keybound(ch, 0);
+    if (!seq) return;
+    for (const char* p = seq; *p; p++) paste_append(*p);
+    free(seq);
+}
+
+/* Start-of-frame: drop delivered pastes, keep a paste still in progress */
+static void paste_frame_reset(void) {
+    if (g_in_paste && g_paste_done > 0) {
+        memmove(g_paste, g_paste + g_paste_done, g_paste_len - g_paste_done);
+        g_paste_len -= g_paste_done;
+    } else if (!g_in_paste) {
+        g_paste_len = 0;
+    }
+    g_paste_done = 0;
+}
+
+/* End marker seen: terminate the paste and queue its event. text is
+ * resolved after the drain, once the buffer can no longer move. */
+static void paste_finish(void) {
+    size_t length = g_paste_len - g_paste_done;
+    g_in_paste = false;
+    if (!paste_append('\0')) {
+        g_paste_len = g_paste_done;     /* Out of memory: drop this paste */
+        return;
+    }
+    g_paste_done = g_paste_len;
+    NCurses_InputEvent* ev = input_event_push(NCURSES_EVENT_PASTE);
+    if (ev) ev->paste.length = length;
+}
+
+/* Point each paste event at its bytes (pastes are stored in event order) */
+static void paste_resolve_events(void) {
+    size_t offset = 0;
+    for (int i = 0; i < g_event_count; i++) {
+        if (g_events[i].type != NCURSES_EVENT_PASTE) continue;
+        g_events[i].paste.text = g_paste + offset;
+        offset += g_events[i].paste.length + 1;
+    }
+}
+
+/* ============================================================================
+ * Mouse
+ * ============================================================================
+ *
+ * SGR reports (CSI < Cb ; Cx ; Cy M/m) are decoded here rather than by
+ * getmouse(): the "\033[<" prefix is bound to CELS_KEY_SGR_MOUSE and the
+ * parameters are read from the same getch() stream. ncurses keeps decoded
+ * mouse events in a small ring that getmouse() pops newest-first, so a
+ * burst of reports within one read would lose events or reorder them.
+ * KEY_MOUSE (X10 reports from terminals without SGR) still goes through
+ * getmouse().
+ */
+
+typedef struct MouseReport {
+    int x, y;               /* 0-based cell */
+    int button;             /* 1-3, 0 = none */
+    bool pressed;
+    bool released;
+    bool motion;
+    int wheel;              /* -1 up, +1 down */
+    int mods;               /* NCURSES_MOD_* */
+} MouseReport;
+
+static int mouse_held_mask(void) {
+    return (NCurses_InputState.mouse_left_held ? NCURSES_HELD_LEFT : 0)
+         | (NCurses_InputState.mouse_middle_held ? NCURSES_HELD_MIDDLE : 0)
+         | (NCurses_InputState.mouse_right_held ? NCURSES_HELD_RIGHT : 0);
+}
+
+static bool* mouse_held_flag(int button) {
+    return button == 1 ? &NCurses_InputState.mouse_left_held
+         : button == 2 ? &NCurses_InputState.mouse_middle_held
+         : &NCurses_InputState.mouse_right_held;
+}
+
+/* Resolve the surface under the event's position */
+static void mouse_resolve_surface(NCurses_InputEvent* ev) {
+    NCurses_SurfaceHit hit = ncurses_surface_hit_test(ev->mouse.x, ev->mouse.y);
+    ev->mouse.surface = hit.entity;
+    ev->mouse.local_x = hit.x;
+    ev->mouse.local_y = hit.y;
+    NCurses_InputState.mouse_surface = hit.entity;
+}
+
+/* Record a motion point. With NCURSES_MOTION_ENDPOINTS, a run of motion
+ * with no other event in between keeps its first point and overwrites
+ * its second with each newer one. */
+static void input_push_motion(const MouseReport* r) {
+    bool continues = g_last_motion >= 0 && g_last_motion == g_event_count - 1;
+    NCurses_InputEvent* ev;
+    if (g_motion_mode == NCURSES_MOTION_ENDPOINTS && continues && g_motion_run >= 2) {
+        ev = &g_events[g_last_motion];
+        ev->time_ns = input_event_time();
+    } else {
+        ev = input_event_push(NCURSES_EVENT_MOUSE);
+        if (!ev) return;
+        g_motion_run = continues ? g_motion_run + 1 : 1;
+        g_last_motion = g_event_count - 1;
+    }
+    ev->mouse.x = r->x;
+    ev->mouse.y = r->y;
+    ev->mouse.motion = true;
+    ev->mouse.held = mouse_held_mask();
+    ev->mouse.mods = r->mods;
+    mouse_resolve_surface(ev);
+}
+
+/* Update the summary fields and append the report to the event list */
+static void input_handle_mouse(const MouseReport* r) {
+    NCurses_InputState.mouse_x = r->x;
+    NCurses_InputState.mouse_y = r->y;
+
+    if (r->motion) {
+        input_push_motion(r);
+        return;
+    }
+
+    if (r->wheel) {
+        NCurses_InputState.mouse_wheel += r->wheel;
+    } else if (r->button) {
+        *mouse_held_flag(r->button) = r->pressed;
+        NCurses_InputState.mouse_button = r->button;
+        NCurses_InputState.mouse_pressed = r->pressed;
+        NCurses_InputState.mouse_released = r->released;
+    } else {
+        return;
+    }
+
+    NCurses_InputEvent* ev = input_event_push(NCURSES_EVENT_MOUSE);
+    if (!ev) return;
+    ev->mouse.x = r->x;
+    ev->mouse.y = r->y;
+    ev->mouse.button = r->button;
+    ev->mouse.pressed = r->pressed;
+    ev->mouse.released = r->released;
+    ev->mouse.wheel = r->wheel;
+    ev->mouse.held = mouse_held_mask();
+    ev->mouse.mods = r->mods;
+    mouse_resolve_surface(ev);
+}
+
+/* Decode an xterm button byte (SGR or X10) at 0-based x, y. Returns
+ * false for reports that are not passed on. */
+static bool mouse_decode(int cb, int x, int y, bool release, MouseReport* r) {
+    memset(r, 0, sizeof(*r));
+    r->x = x;
+    r->y = y;
+    r->mods = ((cb & 4) ? NCURSES_MOD_SHIFT : 0)
+            | ((cb & 8) ? NCURSES_MOD_ALT : 0)
+            | ((cb & 16) ? NCURSES_MOD_CTRL : 0);
+
+    int low = cb & 3;
+    if (cb & 128) {
+        return false;                   /* Buttons 8-11: not reported */
+    } else if (cb & 64) {
+        if (low > 1) return false;      /* Horizontal wheel */
+        r->wheel = low == 0 ? -1 : 1;
+    } else if (cb & 32) {
+        r->motion = true;
+        /* A drag names the button it holds; trust it over our state in
+         * case its press happened outside the window */
+        if (low < 3) *mouse_held_flag(low + 1) = true;
+    } else if (low < 3) {
+        r->button = low + 1;
+        r->pressed = !release;
+        r->released = release;
+    } else if (release) {
+        /* X10 release does not say which button: take a held one */
+        int held = mouse_held_mask();
+        if (!held) return false;
+        r->button = (held & NCURSES_HELD_LEFT) ? 1 : (held & NCURSES_HELD_MIDDLE) ? 2 : 3;
+        r->released = true;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/* SGR report after its prefix, one byte per wgetch(). A report split
+ * across reads may straddle two frames: the rest is picked up by the next
+ * drain instead of blocking inside this one. */
+#define SGR_PARAM_MAX   0xFFFF                  /* Clamp, no int overflow */
+#define SGR_REPORT_MAX  24
+#define SGR_TIMEOUT_NS  (100 * 1000000ull)      /* Rest never came: drop it */
+
+static struct {
+    bool active;
+    int param[3];
+    int n;
+    int len;
+    uint64_t since;
+} g_sgr;
+
+static void sgr_mouse_begin(void) {
+    memset(&g_sgr, 0, sizeof(g_sgr));
+    g_sgr.active = true;
+    g_sgr.since = input_now_ns();
+}
+
+/* Returns true once a complete report decoded into r. A malformed report
+ * is dropped along with the bytes it consumed. */
+static bool sgr_mouse_feed(int ch, MouseReport* r) {
+    if (ch >= '0' && ch <= '9') {
+        int* p = &g_sgr.param[g_sgr.n];
+        *p = *p * 10 + (ch - '0');
+        if (*p > SGR_PARAM_MAX) *p = SGR_PARAM_MAX;
+    } else if (ch == ';' && g_sgr.n < 2) {
+        g_sgr.n++;
+    } else {
+        g_sgr.active = false;
+        if ((ch != 'M' && ch != 'm') || g_sgr.n != 2) return false;
+        return mouse_decode(g_sgr.param[0], g_sgr.param[1] - 1, g_sgr.param[2] - 1,
+                            ch == 'm', r);
+    }
+    if (++g_sgr.len >= SGR_REPORT_MAX) g_sgr.active = false;
+    return false;
+}
+
+/* Convert a getmouse() report (X10 encoding) */
+static void mevent_to_report(const MEVENT* event, MouseReport* r) {
+    mmask_t b = event->bstate;
+    memset(r, 0, sizeof(*r));
+    r->x = event->x;
+    r->y = event->y;
+    r->mods = ((b & BUTTON_SHIFT) ? NCURSES_MOD_SHIFT : 0)
+            | ((b & BUTTON_ALT) ? NCURSES_MOD_ALT : 0)
+            | ((b & BUTTON_CTRL) ? NCURSES_MOD_CTRL : 0);
+
+    if (b & BUTTON4_PRESSED) {
+        r->wheel = -1;
+        return;
+    }
+#ifdef BUTTON5_PRESSED
+    if (b & BUTTON5_PRESSED) {
+        r->wheel = 1;
+        return;
+    }
+#endif
+    if (b & (BUTTON1_PRESSED | BUTTON1_RELEASED)) r->button = 1;
+    else if (b & (BUTTON2_PRESSED | BUTTON2_RELEASED)) r->button = 2;
+    else if (b & (BUTTON3_PRESSED | BUTTON3_RELEASED)) r->button = 3;
+    r->pressed = (b & (BUTTON1_PRESSED | BUTTON2_PRESSED | BUTTON3_PRESSED)) != 0;
+    r->released = !r->pressed
+               && (b & (BUTTON1_RELEASED | BUTTON2_RELEASED | BUTTON3_RELEASED)) != 0;
+
+    /* X10 drags decode as a press of a button that is already down */
+    if (!r->button || (r->pressed && *mouse_held_flag(r->button))) {
+        r->button = 0;
+        r->pressed = false;
+        r->motion = true;
+    }
+}
+
+/* ============================================================================
+ * Pause Mode -- F1 freezes output for text selection/copy
+ * ============================================================================
+ *
+ * Pausing only stops output: NCurses_InputSystem keeps draining input and
+ * OnLoad/OnUpdate keep running at NCurses_WindowConfig.paused_fps.
+ * Mouse reporting is switched off meanwhile so the terminal's own
+ * selection works. The next key resumes and is not reported.
+ */
+
+static void tui_pause(bool paused) {
+    ncurses_window_set_paused(paused);
+    ncurses_terminal_send(paused ? "\033[?1006l\033[?1003l\033[?1000l"
+                                 : "\033[?1000h\033[?1003h\033[?1006h");
+}
+
+/* ============================================================================
+ * Keys
+ * ============================================================================ */
+
+/* Modifiers implied by the custom codes of the ncurses path */
+static int legacy_key_mods(int ch) {
+    switch (ch) {
+    case CELS_KEY_CTRL_UP: case CELS_KEY_CTRL_DOWN:
+    case CELS_KEY_CTRL_RIGHT: case CELS_KEY_CTRL_LEFT:
+        return NCURSES_MOD_CTRL;
+    case CELS_KEY_SHIFT_LEFT: case CELS_KEY_SHIFT_RIGHT:
+        return NCURSES_MOD_SHIFT;
+    default:
+        return 0;
+    }
+}
+
+/* A decoded key from either path: F1 pause, else keys[] and event list */
+static void input_handle_key(int ch, int mods) {
+    /* Internal: F1 pause mode; any key resumes */
+    if (ncurses_window_is_paused()) {
+        tui_pause(false);
+        return;
+    }
+    if (ch == KEY_F(1) && mods == 0) {
+        tui_pause(true);
+        return;
+    }
+
+    /* Event list (all) and keys[] (first 16) */
+    NCurses_InputEvent* ev = input_event_push(NCURSES_EVENT_KEY);
+    if (ev) {
+        ev->key.code = ch;
+        ev->key.mods = mods;
+    }
+    if (NCurses_InputState.key_count < MAX_KEYS_PER_FRAME) {
+        NCurses_InputState.keys[NCurses_InputState.key_count++] = ch;
+    }
+}
+
+/* ============================================================================
+ * Raw Input -- NCursesWindow(.raw_input = true)
+ * ============================================================================
+ *
+ * Bytes are read straight from the input fd and decoded by
+ * tui_input_parser.c; ncurses' getch() is not called. A lone ESC at the
+ * end of the available input is the Escape key at once -- unless the
+ * terminal confirmed the kitty keyboard protocol, where Escape arrives as
+ * CSI 27 u and a bare ESC can only start a sequence (see
+ * tui_input_parser_idle()).
+ */
+
+static void input_handle_token(const TUI_InputToken* tok, void* user) {
+    (void)user;
+    switch (tok->type) {
+    case TUI_TOKEN_KEY: {
+        /* With the kitty protocol Ctrl+C/Z/\ arrive as keys instead of
+         * being turned into signals by the tty */
+        if (tok->mods & NCURSES_MOD_CTRL) {
+            if (tok->code == 3) raise(SIGINT);
+            else if (tok->code == 26) raise(SIGTSTP);
+            else if (tok->code == 28) raise(SIGQUIT);
+        }
+        input_handle_key(tok->code, tok->mods);
+        break;
+    }
+    case TUI_TOKEN_MOUSE: {
+        MouseReport report;
+        if (mouse_decode(tok->code, tok->x, tok->y, tok->release, &report)) {
+            input_handle_mouse(&report);
+        }
+        break;
+    }
+    case TUI_TOKEN_PASTE_BEGIN:
+        g_in_paste = true;
+        break;
+    case TUI_TOKEN_PASTE_BYTE:
+        paste_append((char)tok->code);
+        break;
+    case TUI_TOKEN_PASTE_END:
+        paste_finish();
+        break;
+    case TUI_TOKEN_KITTY_FLAGS:
+        break;                          /* Tracked by the parser */
+    }
+}
+
+static void input_drain_raw(void) {
+    /* getch() is not called, so KEY_RESIZE is never seen: compare sizes */
+    if (COLS != g_raw_cols || LINES != g_raw_lines) {
+        g_raw_cols = COLS;
+        g_raw_lines = LINES;
+        NCurses_InputEvent* ev = input_event_push(NCURSES_EVENT_RESIZE);
+        if (ev) {
+            ev->resize.width = COLS;
+            ev->resize.height = LINES;
+        }
+    }
+
+    /* Input thread: tokens are already decoded, with arrival times */
+    if (ncurses_input_thread_active()) {
+        TUI_InputQueued queued;
+        while (ncurses_input_thread_pop(&queued)) {
+            g_event_time = queued.time_ns;
+            input_handle_token(&queued.tok, NULL);
+        }
+        g_event_time = 0;
+        return;
+    }
+
+    unsigned char buf[4096];
+    struct pollfd pfd = { .fd = g_input_fd, .events = POLLIN };
+    while (poll(&pfd, 1, 0) > 0 && (pfd.revents & POLLIN)) {
+        ssize_t n = read(g_input_fd, buf, sizeof(buf));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        tui_input_parser_feed(buf, (size_t)n, input_handle_token, NULL);
+    }
+
+    tui_input_parser_idle(input_now_ns(), input_handle_token, NULL);
+}
+
+/* ============================================================================
+ * ncurses Input
+ * ============================================================================ */
+
+/* Drain the ncurses getch() queue */
+static void input_drain_ncurses(void) {
+    int ch;
+    while ((ch = wgetch(stdscr)) != ERR) {
+
+        /* Rest of a mouse report split across reads */
+        if (g_sgr.active && input_now_ns() - g_sgr.since > SGR_TIMEOUT_NS) {
+            g_sgr.active = false;
+        }
+        if (g_sgr.active) {
+            MouseReport report;
+            if (sgr_mouse_feed(ch, &report)) input_handle_mouse(&report);
+            continue;
+        }
+
+        /* Bracketed paste: raw bytes go to the paste buffer. Pasted text
+         * that happens to spell a key sequence is stored as that text. */
+        if (g_in_paste && ch != KEY_RESIZE) {
+            g_paste_last_ns = input_now_ns();
+            if (ch == CELS_KEY_PASTE_END) paste_finish();
+            else if (ch >= 0 && ch <= 0xFF) paste_append((char)ch);
+            else paste_append_key(ch);
+            continue;
+        }
+        if (ch == CELS_KEY_PASTE_BEGIN) {
+            g_in_paste = true;
+            g_paste_last_ns = input_now_ns();
+            continue;
+        }
+
+        /* Terminal resize -- recorded once per burst, otherwise
+         * handled by NCurses_WindowUpdateSystem + TUI_SurfaceSystem. */
+        if (ch == KEY_RESIZE) {
+            int next;
+            while ((next = wgetch(stdscr)) == KEY_RESIZE) { /* consume */ }
+            if (next != ERR) ungetch(next);
+            NCurses_InputEvent* ev = input_event_push(NCURSES_EVENT_RESIZE);
+            if (ev) {
+                ev->resize.width = COLS;
+                ev->resize.height = LINES;
+            }
+            continue;
+        }
+
+        /* Mouse events: one event each, final state in the
+         * summary fields */
+        if (ch == CELS_KEY_SGR_MOUSE) {
+            sgr_mouse_begin();
+            continue;
+        }
+        if (ch == KEY_MOUSE) {
+            MEVENT event;
+            MouseReport report;
+            if (getmouse(&event) == OK) {
+                mevent_to_report(&event, &report);
+                input_handle_mouse(&report);
+            }
+            continue;
+        }
+
+        input_handle_key(ch, legacy_key_mods(ch));
+    }
+
+    /* The end marker was lost: deliver what arrived instead of treating
+     * every later key as pasted text */
+    if (g_in_paste && input_now_ns() - g_paste_last_ns >= INPUT_PASTE_TIMEOUT_NS) {
+        paste_finish();
+    }
 }
 
 /* ============================================================================
@@ -69,7 +627,8 @@ static void tui_pause(void) {
  * ============================================================================
  *
  * Each frame: resets per-frame fields (persistent fields carry over),
- * drains the ncurses input queue. cel_mutate auto-notifies at end.
+ * drains the ncurses input queue (or the raw input fd). cel_mutate
+ * auto-notifies at end.
  */
 
 CEL_System(NCurses_InputSystem, .phase = OnLoad) {
@@ -81,77 +640,29 @@ CEL_System(NCurses_InputSystem, .phase = OnLoad) {
             NCurses_InputState.mouse_button = 0;
             NCurses_InputState.mouse_pressed = false;
             NCurses_InputState.mouse_released = false;
+            NCurses_InputState.mouse_wheel = 0;
+            g_event_count = 0;
+            g_last_motion = -1;
+            g_motion_run = 0;
+            paste_frame_reset();
+
+            if (g_raw_input) input_drain_raw();
+            else input_drain_ncurses();
 
-            /* Drain all queued keys */
-            int ch;
-            while ((ch = wgetch(stdscr)) != ERR) {
-
-                /* Internal: terminal resize -- consume and drop.
-                 * Resize handled by NCurses_WindowUpdateSystem + TUI_SurfaceSystem. */
-                if (ch == KEY_RESIZE) {
-                    int next;
-                    while ((next = wgetch(stdscr)) == KEY_RESIZE) { /* consume */ }
-                    if (next != ERR) ungetch(next);
-                    continue;
-                }
-
-                /* Internal: F1 pause mode */
-                if (ch == KEY_F(1)) {
-                    tui_pause();
-                    continue;
-                }
-
-                /* Mouse events -- drain all queued, keep final state */
-                if (ch == KEY_MOUSE) {
-                    MEVENT event;
-                    do {
-                        if (getmouse(&event) != OK) break;
-
-                        NCurses_InputState.mouse_x = event.x;
-                        NCurses_InputState.mouse_y = event.y;
-
-                        if (event.bstate & BUTTON1_PRESSED) {
-                            NCurses_InputState.mouse_button = 1;
-                            NCurses_InputState.mouse_pressed = true;
-                            NCurses_InputState.mouse_released = false;
-                            NCurses_InputState.mouse_left_held = true;
-                        } else if (event.bstate & BUTTON1_RELEASED) {
-                            NCurses_InputState.mouse_button = 1;
-                            NCurses_InputState.mouse_pressed = false;
-                            NCurses_InputState.mouse_released = true;
-                            NCurses_InputState.mouse_left_held = false;
-                        } else if (event.bstate & BUTTON2_PRESSED) {
-                            NCurses_InputState.mouse_button = 2;
-                            NCurses_InputState.mouse_pressed = true;
-                            NCurses_InputState.mouse_released = false;
-                            NCurses_InputState.mouse_middle_held = true;
-                        } else if (event.bstate & BUTTON2_RELEASED) {
-                            NCurses_InputState.mouse_button = 2;
-                            NCurses_InputState.mouse_pressed = false;
-                            NCurses_InputState.mouse_released = true;
-                            NCurses_InputState.mouse_middle_held = false;
-                        } else if (event.bstate & BUTTON3_PRESSED) {
-                            NCurses_InputState.mouse_button = 3;
-                            NCurses_InputState.mouse_pressed = true;
-                            NCurses_InputState.mouse_released = false;
-                            NCurses_InputState.mouse_right_held = true;
-                        } else if (event.bstate & BUTTON3_RELEASED) {
-                            NCurses_InputState.mouse_button = 3;
-                            NCurses_InputState.mouse_pressed = false;
-                            NCurses_InputState.mouse_released = true;
-                            NCurses_InputState.mouse_right_held = false;
-                        }
-                    } while ((ch = wgetch(stdscr)) == KEY_MOUSE);
-
-                    if (ch != ERR) ungetch(ch);
-                    continue;
-                }
-
-                /* All other keys: add to keys[] array */
-                if (NCurses_InputState.key_count < MAX_KEYS_PER_FRAME) {
-                    NCurses_InputState.keys[NCurses_InputState.key_count++] = ch;
-                }
+            paste_resolve_events();
+            NCurses_InputState.events = g_events;
+            NCurses_InputState.event_count = g_event_count;
+
+            /* Arrival span for the latency tracer (tui_latency.c) */
+            uint64_t oldest = 0, newest = 0;
+            for (int i = 0; i < g_event_count; i++) {
+                uint64_t t = g_events[i].time_ns;
+                if (!oldest || t < oldest) oldest = t;
+                if (t > newest) newest = t;
             }
+            NCurses_InputState.input_oldest_ns = oldest;
+            NCurses_InputState.input_newest_ns = newest;
+            if (!ncurses_window_is_paused()) ncurses_latency_input(oldest, newest);
         }
     }
 }
@@ -160,12 +671,13 @@ CEL_System(NCurses_InputSystem, .phase = OnLoad) {
  * Terminal Configuration -- called after initscr()
  * ============================================================================ */
 
-void ncurses_input_configure_terminal(void) {
+void ncurses_input_configure_terminal(const NCurses_WindowConfig* config) {
     /* Ensure this TU's state ID is set (idempotent) */
     NCurses_InputState_register();
     cels_state_bind(NCurses_InputState);
     NCurses_InputState.mouse_x = -1;
     NCurses_InputState.mouse_y = -1;
+    NCurses_InputState.mouse_surface = 0;
 
     /* Register xterm-compatible Ctrl+Arrow escape sequences */
     define_key("\033[1;5A", CELS_KEY_CTRL_UP);
@@ -177,11 +689,68 @@ void ncurses_input_configure_terminal(void) {
     define_key("\033[1;2D", CELS_KEY_SHIFT_LEFT);
     define_key("\033[1;2C", CELS_KEY_SHIFT_RIGHT);
 
-    /* Enable mouse events: buttons 1-3 press/release + position tracking */
+    /* Bracketed paste: the terminal wraps pasted text in these markers */
+    define_key("\033[200~", CELS_KEY_PASTE_BEGIN);
+    define_key("\033[201~", CELS_KEY_PASTE_END);
+    ncurses_terminal_send("\033[?2004h");
+    g_in_paste = false;
+    g_paste_len = 0;
+    g_paste_done = 0;
+    g_sgr.active = false;
+
+    /* Enable mouse events: buttons 1-3 press/release, wheel, modifiers
+     * and position tracking */
     mmask_t desired = BUTTON1_PRESSED | BUTTON1_RELEASED
                     | BUTTON2_PRESSED | BUTTON2_RELEASED
                     | BUTTON3_PRESSED | BUTTON3_RELEASED
+                    | BUTTON4_PRESSED
+#ifdef BUTTON5_PRESSED
+                    | BUTTON5_PRESSED
+#endif
+                    | BUTTON_SHIFT | BUTTON_ALT | BUTTON_CTRL
                     | REPORT_MOUSE_POSITION;
     mousemask(desired, NULL);
     mouseinterval(0);
+    g_motion_mode = config && config->mouse_motion == NCURSES_MOTION_ENDPOINTS
+                  ? NCURSES_MOTION_ENDPOINTS : NCURSES_MOTION_ALL;
+
+    /* ncurses only turns on click reporting (1000); motion needs any-event
+     * tracking (1003). SGR encoding (1006) lifts the 223-column limit of
+     * X10 reports; its prefix replaces any terminfo kmous binding so the
+     * reports reach sgr_mouse_feed(). */
+    define_key("\033[<", CELS_KEY_SGR_MOUSE);
+    ncurses_terminal_send("\033[?1003h\033[?1006h");
+
+    /* Raw input: push kitty keyboard flags (disambiguate) and ask whether
+     * they took; terminals without the protocol ignore both. typeahead
+     * would make doupdate() stop early whenever input is pending, which
+     * is now most of the time between our reads. */
+    g_raw_input = config && (config->raw_input || config->input_thread);
+    if (g_raw_input) {
+        g_input_fd = ncurses_window_input_fd();
+        g_raw_cols = COLS;
+        g_raw_lines = LINES;
+        tui_input_parser_reset();
+        tui_input_parser_set_kitty(false);
+        typeahead(-1);
+        ncurses_terminal_send("\033[>1u\033[?u");
+        if (config->input_thread) ncurses_input_thread_start(g_input_fd);
+    }
+}
+
+/* Set the modes above again on a terminal that missed them (a session
+ * client attaching). Mouse reporting stays off while paused. */
+void ncurses_input_resend_modes(void) {
+    ncurses_terminal_send("\033[?2004h");
+    if (!ncurses_window_is_paused())
+        ncurses_terminal_send("\033[?1000h\033[?1003h\033[?1006h");
+    if (g_raw_input) ncurses_terminal_send("\033[>1u\033[?u");
+}
+
+/* Undo terminal modes set above. Called before endwin(), which flushes. */
+void ncurses_input_restore_terminal(void) {
+    ncurses_input_thread_stop();
+    ncurses_terminal_send("\033[?2004l");
+    ncurses_terminal_send("\033[?1006l\033[?1003l");
+    if (g_raw_input) ncurses_terminal_send("\033[<u");
 }
@@ -0,0 +1,446 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * TUI Input Parser - VT/xterm escape sequences from raw bytes
+ *
+ * Used by NCurses_InputSystem when NCursesWindow(.raw_input = true): bytes
+ * are read from the input fd and decoded here instead of by ncurses'
+ * keypad matching, so no ESCDELAY applies.
+ *
+ * A small state machine splits the stream into plain bytes, ESC-prefixed
+ * bytes (Alt+key), SS3 and CSI sequences. CSI sequences are decoded
+ * generically -- parameters, then a lookup of the final byte (or of the
+ * first parameter for "~" sequences) in the tables below -- and the xterm
+ * modifier parameter (1 + shift/alt/ctrl bits) applies to every key.
+ * Kitty keyboard protocol reports (CSI code ; mods u) use the same path.
+ *
+ * A lone ESC is ambiguous only when it is the last byte available. The
+ * reader calls tui_input_parser_idle() once it has drained its fd: legacy
+ * terminals write a whole sequence at once, so a held ESC is the Escape
+ * key right away. Once the terminal confirms the kitty protocol, Escape
+ * itself is CSI 27 u and a bare ESC can only start a sequence split across
+ * reads, so it is held (up to PARSER_TIMEOUT_NS) for the rest.
+ *
+ * Decoded keys use the ncurses key codes the ncurses path reports, so
+ * applications see the same values either way.
+ *
+ * State lives in statics like the rest of the input code (one terminal).
+ */
+
+#include "../tui_internal.h"
+#include <ncurses.h>
+#include <stdint.h>
+#include <string.h>
+
+#define PARSER_MAX_PARAMS 8
+
+/* Drop a sequence still incomplete after this long */
+#define PARSER_TIMEOUT_NS (50 * 1000000ull)
+
+/* End a paste whose end marker never came after this long without bytes */
+#define PARSER_PASTE_TIMEOUT_NS (1000 * 1000000ull)
+
+typedef enum ParserState {
+    PARSER_GROUND,
+    PARSER_ESC,         /* After ESC */
+    PARSER_SS3,         /* After ESC O */
+    PARSER_CSI,         /* After ESC [ */
+    PARSER_X10,         /* After CSI M: three raw mouse bytes */
+    PARSER_PASTE        /* Inside a bracketed paste */
+} ParserState;
+
+static ParserState g_state = PARSER_GROUND;
+static char g_private = 0;              /* CSI marker: '<', '?', '>' or '=' */
+static int g_params[PARSER_MAX_PARAMS];
+static int g_param_count = 0;
+static bool g_in_subparam = false;      /* After ':' -- kitty alternates, ignored */
+static unsigned char g_x10[3];
+static int g_x10_len = 0;
+static int g_paste_match = 0;           /* Bytes of PASTE_END matched so far */
+static bool g_kitty = false;            /* Terminal confirmed the kitty protocol */
+static uint64_t g_pending_since = 0;    /* When the pending sequence stalled */
+
+static const char PASTE_END[] = "\033[201~";
+
+/* ============================================================================
+ * Key Tables
+ * ============================================================================ */
+
+/* CSI <final> and SS3 <final> */
+static const struct { char final; int code; } LETTER_KEYS[] = {
+    { 'A', KEY_UP },    { 'B', KEY_DOWN },  { 'C', KEY_RIGHT }, { 'D', KEY_LEFT },
+    { 'H', KEY_HOME },  { 'F', KEY_END },   { 'E', KEY_B2 },
+    { 'P', KEY_F(1) },  { 'Q', KEY_F(2) },  { 'R', KEY_F(3) },  { 'S', KEY_F(4) },
+    { 'Z', KEY_BTAB },  { 'M', '\n' },
+};
+
+/* CSI <number> ~ */
+static const struct { int number; int code; } TILDE_KEYS[] = {
+    { 1, KEY_HOME },    { 2, KEY_IC },      { 3, KEY_DC },      { 4, KEY_END },
+    { 5, KEY_PPAGE },   { 6, KEY_NPAGE },   { 7, KEY_HOME },    { 8, KEY_END },
+    { 11, KEY_F(1) },   { 12, KEY_F(2) },   { 13, KEY_F(3) },   { 14, KEY_F(4) },
+    { 15, KEY_F(5) },   { 17, KEY_F(6) },   { 18, KEY_F(7) },   { 19, KEY_F(8) },
+    { 20, KEY_F(9) },   { 21, KEY_F(10) },  { 23, KEY_F(11) },  { 24, KEY_F(12) },
+};
+
+/* CSI <code> u: kitty codes that differ from the ncurses key code */
+static const struct { int number; int code; } KITTY_KEYS[] = {
+    { 13, '\n' },       { 127, KEY_BACKSPACE },
+    { 57399, '0' },     { 57400, '1' },     { 57401, '2' },     { 57402, '3' },
+    { 57403, '4' },     { 57404, '5' },     { 57405, '6' },     { 57406, '7' },
+    { 57407, '8' },     { 57408, '9' },     { 57414, '\n' },
+};
+
+/* Modified keys that keep the custom codes registered for the ncurses path */
+static const struct { int code; int mods; int custom; } CUSTOM_KEYS[] = {
+    { KEY_UP,    NCURSES_MOD_CTRL,  CELS_KEY_CTRL_UP },
+    { KEY_DOWN,  NCURSES_MOD_CTRL,  CELS_KEY_CTRL_DOWN },
+    { KEY_RIGHT, NCURSES_MOD_CTRL,  CELS_KEY_CTRL_RIGHT },
+    { KEY_LEFT,  NCURSES_MOD_CTRL,  CELS_KEY_CTRL_LEFT },
+    { KEY_LEFT,  NCURSES_MOD_SHIFT, CELS_KEY_SHIFT_LEFT },
+    { KEY_RIGHT, NCURSES_MOD_SHIFT, CELS_KEY_SHIFT_RIGHT },
+    { KEY_UP,    NCURSES_MOD_SHIFT, KEY_SR },
+    { KEY_DOWN,  NCURSES_MOD_SHIFT, KEY_SF },
+};
+
+#define TABLE_LEN(t) ((int)(sizeof(t) / sizeof((t)[0])))
+
+/* ============================================================================
+ * Token Output
+ * ============================================================================ */
+
+static void emit(TUI_InputTokenFn fn, void* user, TUI_InputTokenType type,
+                 int code, int mods) {
+    TUI_InputToken tok = { .type = type, .code = code, .mods = mods };
+    fn(&tok, user);
+}
+
+/* xterm modifier parameter: 1 + (shift | alt << 1 | ctrl << 2 | ...) */
+static int decode_mods(int param) {
+    int bits = param > 1 ? param - 1 : 0;
+    return ((bits & 1) ? NCURSES_MOD_SHIFT : 0)
+         | ((bits & 2) ? NCURSES_MOD_ALT : 0)
+         | ((bits & 4) ? NCURSES_MOD_CTRL : 0);
+}
+
+/* Emit a decoded key, mapping modified arrows to their custom codes */
+static void emit_key(TUI_InputTokenFn fn, void* user, int code, int mods) {
+    for (int i = 0; i < TABLE_LEN(CUSTOM_KEYS); i++) {
+        if (CUSTOM_KEYS[i].code == code && CUSTOM_KEYS[i].mods == mods) {
+            code = CUSTOM_KEYS[i].custom;
+            break;
+        }
+    }
+    emit(fn, user, TUI_TOKEN_KEY, code, mods);
+}
+
+/* A plain byte as the ncurses path reports it (nl mode, kbs = ^?, so
+ * 0x08 stays Ctrl+H) */
+static void emit_byte(TUI_InputTokenFn fn, void* user, unsigned char b, int mods) {
+    int code = b;
+    if (b == '\r') code = '\n';
+    else if (b == 0x7F) code = KEY_BACKSPACE;
+    emit(fn, user, TUI_TOKEN_KEY, code, mods);
+}
+
+/* Emit a codepoint as UTF-8 bytes, the way the ncurses path reports text */
+static void emit_codepoint(TUI_InputTokenFn fn, void* user, int cp, int mods) {
+    unsigned char utf8[4];
+    int n;
+    if (cp < 0x80) {
+        utf8[0] = (unsigned char)cp;
+        n = 1;
+    } else if (cp < 0x800) {
+        utf8[0] = (unsigned char)(0xC0 | (cp >> 6));
+        utf8[1] = (unsigned char)(0x80 | (cp & 0x3F));
+        n = 2;
+    } else if (cp < 0x10000) {
+        utf8[0] = (unsigned char)(0xE0 | (cp >> 12));
+        utf8[1] = (unsigned char)(0x80 | ((cp >> 6) & 0x3F));
+        utf8[2] = (unsigned char)(0x80 | (cp & 0x3F));
+        n = 3;
+    } else {
+        utf8[0] = (unsigned char)(0xF0 | (cp >> 18));
+        utf8[1] = (unsigned char)(0x80 | ((cp >> 12) & 0x3F));
+        utf8[2] = (unsigned char)(0x80 | ((cp >> 6) & 0x3F));
+        utf8[3] = (unsigned char)(0x80 | (cp & 0x3F));
+        n = 4;
+    }
+    for (int i = 0; i < n; i++) emit(fn, user, TUI_TOKEN_KEY, utf8[i], mods);
+}
+
+/* ============================================================================
+ * Sequence Decoding
+ * ============================================================================ */
+
+static int param(int i, int fallback) {
+    return i < g_param_count && g_params[i] > 0 ? g_params[i] : fallback;
+}
+
+/* CSI code ; mods u -- kitty keyboard protocol */
+static void decode_kitty(TUI_InputTokenFn fn, void* user) {
+    int cp = param(0, 0);
+    int mods = decode_mods(param(1, 1));
+
+    for (int i = 0; i < TABLE_LEN(KITTY_KEYS); i++) {
+        if (KITTY_KEYS[i].number == cp) {
+            emit_key(fn, user, KITTY_KEYS[i].code, mods);
+            return;
+        }
+    }
+    if (cp >= 57344 && cp <= 63743) return;     /* Other functional keys */
+
+    /* Ctrl+letter keeps its control code, as a legacy terminal sends it */
+    if ((mods & NCURSES_MOD_CTRL) && cp >= 'a' && cp <= 'z') {
+        emit(fn, user, TUI_TOKEN_KEY, cp & 0x1F, mods);
+        return;
+    }
+    emit_codepoint(fn, user, cp, mods);
+}
+
+static void decode_csi(unsigned char final, TUI_InputTokenFn fn, void* user) {
+    if (g_private == '<') {
+        if (final != 'M' && final != 'm') return;
+        TUI_InputToken tok = {
+            .type = TUI_TOKEN_MOUSE,
+            .code = param(0, 0),
+            .x = param(1, 1) - 1,
+            .y = param(2, 1) - 1,
+            .release = final == 'm'
+        };
+        fn(&tok, user);
+        return;
+    }
+    if (g_private == '?') {
+        if (final == 'u') {
+            g_kitty = param(0, 0) != 0;
+            emit(fn, user, TUI_TOKEN_KITTY_FLAGS, param(0, 0), 0);
+        }
+        return;
+    }
+    if (g_private) return;
+
+    if (final == 'u') {
+        decode_kitty(fn, user);
+        return;
+    }
+    if (final == '~') {
+        int number = param(0, 0);
+        if (number == 200) {
+            g_state = PARSER_PASTE;
+            g_paste_match = 0;
+            g_pending_since = 0;
+            emit(fn, user, TUI_TOKEN_PASTE_BEGIN, 0, 0);
+            return;
+        }
+        for (int i = 0; i < TABLE_LEN(TILDE_KEYS); i++) {
+            if (TILDE_KEYS[i].number == number) {
+                emit_key(fn, user, TILDE_KEYS[i].code, decode_mods(param(1, 1)));
+                return;
+            }
+        }
+        return;
+    }
+    for (int i = 0; i < TABLE_LEN(LETTER_KEYS); i++) {
+        if (LETTER_KEYS[i].final == (char)final) {
+            emit_key(fn, user, LETTER_KEYS[i].code, decode_mods(param(1, 1)));
+            return;
+        }
+    }
+}
+
+static void decode_ss3(unsigned char final, TUI_InputTokenFn fn, void* user) {
+    for (int i = 0; i < TABLE_LEN(LETTER_KEYS); i++) {
+        if (LETTER_KEYS[i].final == (char)final) {
+            emit_key(fn, user, LETTER_KEYS[i].code, 0);
+            return;
+        }
+    }
+}
+
+static void csi_begin(void) {
+    g_state = PARSER_CSI;
+    g_private = 0;
+    g_param_count = 0;
+    g_in_subparam = false;
+    memset(g_params, 0, sizeof(g_params));
+}
+
+/* One byte of a CSI sequence */
+static void csi_byte(unsigned char b, TUI_InputTokenFn fn, void* user) {
+    if (b >= '0' && b <= '9') {
+        if (g_param_count == 0) g_param_count = 1;
+        int i = g_param_count - 1;
+        if (!g_in_subparam && i < PARSER_MAX_PARAMS && g_params[i] < 100000) {
+            g_params[i] = g_params[i] * 10 + (b - '0');
+        }
+    } else if (b == ';') {
+        if (g_param_count == 0) g_param_count = 1;
+        if (g_param_count < PARSER_MAX_PARAMS) g_param_count++;
+        g_in_subparam = false;
+    } else if (b == ':') {
+        g_in_subparam = true;
+    } else if (b >= '<' && b <= '?') {
+        g_private = (char)b;
+    } else if (b >= 0x20 && b <= 0x2F) {
+        /* Intermediate byte: no key sequence uses one */
+    } else if (b >= 0x40 && b <= 0x7E) {
+        g_state = PARSER_GROUND;
+        if (b == 'M' && g_param_count == 0 && !g_private) {
+            g_state = PARSER_X10;       /* Legacy mouse: CSI M cb cx cy */
+            g_x10_len = 0;
+            return;
+        }
+        decode_csi(b, fn, user);
+    } else {
+        g_state = PARSER_GROUND;        /* Control byte aborts the sequence */
+    }
+}
+
+/* Paste body: everything up to CSI 201 ~ is passed through as raw bytes */
+static void paste_byte(unsigned char b, TUI_InputTokenFn fn, void* user) {
+    if (b == (unsigned char)PASTE_END[g_paste_match]) {
+        if (PASTE_END[++g_paste_match] == '\0') {
+            g_state = PARSER_GROUND;
+            g_paste_match = 0;
+            emit(fn, user, TUI_TOKEN_PASTE_END, 0, 0);
+        }
+        return;
+    }
+    /* Mismatch: the matched prefix was paste content */
+    for (int i = 0; i < g_paste_match; i++) {
+        emit(fn, user, TUI_TOKEN_PASTE_BYTE, (unsigned char)PASTE_END[i], 0);
+    }
+    g_paste_match = 0;
+    if (b == (unsigned char)PASTE_END[0]) {
+        g_paste_match = 1;
+        return;
+    }
+    emit(fn, user, TUI_TOKEN_PASTE_BYTE, b, 0);
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================ */
+
+void tui_input_parser_reset(void) {
+    g_state = PARSER_GROUND;
+    g_paste_match = 0;
+    g_x10_len = 0;
+    g_pending_since = 0;
+}
+
+void tui_input_parser_set_kitty(bool confirmed) {
+    g_kitty = confirmed;
+}
+
+void tui_input_parser_feed(const unsigned char* bytes, size_t len,
+                           TUI_InputTokenFn fn, void* user) {
+    for (size_t i = 0; i < len; i++) {
+        unsigned char b = bytes[i];
+        switch (g_state) {
+        case PARSER_GROUND:
+            if (b == 0x1B) g_state = PARSER_ESC;
+            else emit_byte(fn, user, b, 0);
+            break;
+
+        case PARSER_ESC:
+            if (b == '[') {
+                csi_begin();
+            } else if (b == 'O') {
+                g_state = PARSER_SS3;
+            } else if (b == 0x1B) {
+                emit(fn, user, TUI_TOKEN_KEY, 0x1B, 0);   /* ESC ESC: first is Escape */
+            } else {
+                g_state = PARSER_GROUND;
+                emit_byte(fn, user, b, NCURSES_MOD_ALT);
+            }
+            break;
+
+        case PARSER_SS3:
+            g_state = PARSER_GROUND;
+            decode_ss3(b, fn, user);
+            break;
+
+        case PARSER_CSI:
+            csi_byte(b, fn, user);
+            break;
+
+        case PARSER_X10:
+            g_x10[g_x10_len++] = b;
+            if (g_x10_len == 3) {
+                g_state = PARSER_GROUND;
+                int cb = g_x10[0] - 32;
+                TUI_InputToken tok = {
+                    .type = TUI_TOKEN_MOUSE,
+                    .code = cb,
+                    .x = g_x10[1] - 33,
+                    .y = g_x10[2] - 33,
+                    .release = (cb & 3) == 3 && !(cb & 96)
+                };
+                fn(&tok, user);
+            }
+            break;
+
+        case PARSER_PASTE:
+            g_pending_since = 0;        /* Paste still arriving */
+            paste_byte(b, fn, user);
+            break;
+        }
+    }
+}
+
+static bool parser_pending(void) {
+    return g_state != PARSER_GROUND;
+}
+
+/* No more bytes are available for now. A held ESC is the Escape key (and a
+ * held ESC O is Alt+O) unless the kitty protocol is confirmed; any
+ * sequence still incomplete after
+ * PARSER_TIMEOUT_NS is dropped, and a paste that stops arriving for
+ * PARSER_PASTE_TIMEOUT_NS is ended as if its end marker had come. Returns
+ * the ns left until that timeout, or -1 when nothing is pending. */
+int64_t tui_input_parser_idle(uint64_t now_ns, TUI_InputTokenFn fn, void* user) {
+    if (g_state == PARSER_ESC && !g_kitty) {
+        g_state = PARSER_GROUND;
+        emit(fn, user, TUI_TOKEN_KEY, 0x1B, 0);
+    } else if (g_state == PARSER_SS3 && !g_kitty) {
+        g_state = PARSER_GROUND;
+        emit_byte(fn, user, 'O', NCURSES_MOD_ALT);     /* ESC O was Alt+O */
+    }
+    if (!parser_pending()) {
+        g_pending_since = 0;
+        return -1;
+    }
+    if (!g_pending_since) g_pending_since = now_ns;
+    uint64_t limit = g_state == PARSER_PASTE ? PARSER_PASTE_TIMEOUT_NS : PARSER_TIMEOUT_NS;
+    uint64_t waited = now_ns - g_pending_since;
+    if (waited < limit) return (int64_t)(limit - waited);
+
+    if (g_state == PARSER_ESC) emit(fn, user, TUI_TOKEN_KEY, 0x1B, 0);
+    if (g_state == PARSER_SS3) emit_byte(fn, user, 'O', NCURSES_MOD_ALT);
+    if (g_state == PARSER_PASTE) {
+        for (int i = 0; i < g_paste_match; i++) {
+            emit(fn, user, TUI_TOKEN_PASTE_BYTE, (unsigned char)PASTE_END[i], 0);
+        }
+        g_paste_match = 0;
+        emit(fn, user, TUI_TOKEN_PASTE_END, 0, 0);
+    }
+    g_state = PARSER_GROUND;
+    g_pending_since = 0;
+    return -1;
+}
@@ -0,0 +1,296 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * TUI Input Thread - Terminal input read off the frame loop
+ *
+ * With NCursesWindow(.input_thread = true) a reader thread blocks in poll()
+ * on the input fd, decodes bytes with tui_input_parser.c as they arrive and
+ * pushes each token, stamped with its arrival time, into a single-producer
+ * single-consumer ring. NCurses_InputSystem pops the ring at OnLoad without
+ * a syscall; the parser is only ever touched by the reader.
+ *
+ * The ring is a fixed power-of-two array with free-running head (written
+ * by the reader) and tail (written by the frame loop) indices published
+ * with release stores. When it is full the reader waits for the frame loop
+ * instead of dropping input.
+ *
+ * After each batch the reader writes one byte to a wake pipe (at most one
+ * byte outstanding). tui_hook_frame_end() sleeps on that pipe instead of
+ * usleep(), so a key pressed during the FPS sleep starts the next frame at
+ * once. A single state word covers both the flag and the byte: the reader
+ * claims it with a CAS before writing, and the frame loop only resets it
+ * once the byte is in the pipe and drained, so no stray byte outlives it.
+ *
+ * If the input fd reaches EOF or fails, the reader reports it, flags the
+ * loss and wakes the frame loop, which then quits as on SIGINT.
+ */
+
+#include "../tui_internal.h"
+#include <pthread.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/select.h>
+
+#define INPUT_RING_SIZE     8192            /* Entries, power of two */
+#define INPUT_READ_SIZE     4096
+#define INPUT_FULL_WAIT_MS  1
+
+/* Wake pipe state: only the reader leaves IDLE, only the frame loop
+ * returns to it from SENT */
+#define WAKE_IDLE       0
+#define WAKE_WRITING    1                   /* Reader claimed it, byte in flight */
+#define WAKE_SENT       2                   /* One byte is in the pipe */
+
+static TUI_InputQueued g_ring[INPUT_RING_SIZE];
+static size_t g_head = 0;           /* Next slot to write (reader, atomic) */
+static size_t g_tail = 0;           /* Next slot to read (frame loop, atomic) */
+
+static bool g_thread_active = false;
+static pthread_t g_reader;
+static int g_input_fd = -1;
+static int g_stop_pipe[2] = { -1, -1 };     /* Frame loop -> reader: exit */
+static int g_wake_pipe[2] = { -1, -1 };     /* Reader -> frame loop: input */
+static int g_wake_state = 0;                /* WAKE_* (atomic) */
+static int g_stop = 0;                      /* Reader should exit (atomic) */
+static int g_lost = 0;                      /* Reader hit EOF or an error (atomic) */
+
+static uint64_t g_batch_time = 0;           /* Arrival time of the current read */
+
+/* ============================================================================
+ * Reader Thread
+ * ============================================================================ */
+
+static uint64_t thread_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void wake_frame_loop(void) {
+    int idle = WAKE_IDLE;
+    if (!__atomic_compare_exchange_n(&g_wake_state, &idle, WAKE_WRITING, false,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) return;
+    char byte = 1;
+    int next = write(g_wake_pipe[1], &byte, 1) == 1 ? WAKE_SENT : WAKE_IDLE;
+    __atomic_store_n(&g_wake_state, next, __ATOMIC_RELEASE);
+}
+
+/* Parser callback: queue one token, waiting while the ring is full */
+static void reader_push(const TUI_InputToken* tok, void* user) {
+    (void)user;
+    size_t head = __atomic_load_n(&g_head, __ATOMIC_RELAXED);
+    while (head - __atomic_load_n(&g_tail, __ATOMIC_ACQUIRE) == INPUT_RING_SIZE) {
+        if (__atomic_load_n(&g_stop, __ATOMIC_ACQUIRE)) return;
+        wake_frame_loop();
+        struct pollfd pfd = { .fd = g_stop_pipe[0], .events = POLLIN };
+        poll(&pfd, 1, INPUT_FULL_WAIT_MS);
+    }
+
+    TUI_InputQueued* slot = &g_ring[head & (INPUT_RING_SIZE - 1)];
+    slot->tok = *tok;
+    slot->time_ns = g_batch_time;
+    __atomic_store_n(&g_head, head + 1, __ATOMIC_RELEASE);
+}
+
+static void* input_reader(void* arg) {
+    (void)arg;
+
+    /* Signals belong to the main thread (see output_writer) */
+    sigset_t all;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, NULL);
+
+    unsigned char buf[INPUT_READ_SIZE];
+    int timeout_ms = -1;
+    const char* lost = NULL;
+
+    while (!__atomic_load_n(&g_stop, __ATOMIC_ACQUIRE)) {
+        struct pollfd pfd[2] = {
+            { .fd = g_input_fd, .events = POLLIN },
+            { .fd = g_stop_pipe[0], .events = POLLIN },
+        };
+        int pr = poll(pfd, 2, timeout_ms);
+        if (pr < 0 && errno != EINTR) {
+            lost = strerror(errno);
+            break;
+        }
+        if (pfd[1].revents) break;
+
+        size_t before = __atomic_load_n(&g_head, __ATOMIC_RELAXED);
+        if (pr > 0 && (pfd[0].revents & (POLLIN | POLLHUP | POLLERR))) {
+            ssize_t n = read(g_input_fd, buf, sizeof(buf));
+            if (n == 0) {
+                lost = "end of input";
+                break;
+            }
+            if (n < 0 && errno != EINTR && errno != EAGAIN) {
+                lost = strerror(errno);
+                break;
+            }
+            if (n > 0) {
+                g_batch_time = thread_now_ns();
+                tui_input_parser_feed(buf, (size_t)n, reader_push, NULL);
+
+                /* More bytes already waiting: keep reading before idling */
+                struct pollfd more = { .fd = g_input_fd, .events = POLLIN };
+                if (poll(&more, 1, 0) > 0) {
+                    timeout_ms = 0;
+                    if (__atomic_load_n(&g_head, __ATOMIC_RELAXED) != before) wake_frame_loop();
+                    continue;
+                }
+            }
+        }
+
+        g_batch_time = thread_now_ns();
+        int64_t left_ns = tui_input_parser_idle(g_batch_time, reader_push, NULL);
+        timeout_ms = left_ns < 0 ? -1 : (int)(left_ns / 1000000) + 1;
+        if (__atomic_load_n(&g_head, __ATOMIC_RELAXED) != before) wake_frame_loop();
+    }
+
+    if (lost) {
+        fprintf(stderr, "[NCurses] Input reader stopped: %s\n", lost);
+        __atomic_store_n(&g_lost, 1, __ATOMIC_RELEASE);
+        wake_frame_loop();
+    }
+    return NULL;
+}
+
+/* ============================================================================
+ * Lifecycle
+ * ============================================================================ */
+
+static void close_pipe(int p[2]) {
+    if (p[0] >= 0) close(p[0]);
+    if (p[1] >= 0) close(p[1]);
+    p[0] = p[1] = -1;
+}
+
+static bool open_pipe(int p[2]) {
+    if (pipe(p) != 0) return false;
+    for (int i = 0; i < 2; i++) {
+        fcntl(p[i], F_SETFL, fcntl(p[i], F_GETFL) | O_NONBLOCK);
+        fcntl(p[i], F_SETFD, FD_CLOEXEC);
+    }
+    return true;
+}
+
+bool ncurses_input_thread_start(int input_fd) {
+    if (g_thread_active || input_fd < 0) return false;
+    if (!open_pipe(g_stop_pipe)) return false;
+    if (!open_pipe(g_wake_pipe)) {
+        close_pipe(g_stop_pipe);
+        return false;
+    }
+
+    g_input_fd = input_fd;
+    g_head = 0;
+    g_tail = 0;
+    g_stop = 0;
+    g_lost = 0;
+    g_wake_state = WAKE_IDLE;
+    if (pthread_create(&g_reader, NULL, input_reader, NULL) != 0) {
+        close_pipe(g_stop_pipe);
+        close_pipe(g_wake_pipe);
+        g_input_fd = -1;
+        return false;
+    }
+
+    g_thread_active = true;
+    return true;
+}
+
+void ncurses_input_thread_stop(void) {
+    if (!g_thread_active) return;
+
+    __atomic_store_n(&g_stop, 1, __ATOMIC_RELEASE);
+    char byte = 1;
+    if (write(g_stop_pipe[1], &byte, 1) < 0) { /* Reader also polls g_stop */ }
+    pthread_join(g_reader, NULL);
+
+    close_pipe(g_stop_pipe);
+    close_pipe(g_wake_pipe);
+    g_input_fd = -1;
+    g_thread_active = false;
+}
+
+bool ncurses_input_thread_active(void) {
+    return g_thread_active;
+}
+
+/* The reader stopped on its own (EOF or read error): no more input */
+bool ncurses_input_thread_lost(void) {
+    return g_thread_active && __atomic_load_n(&g_lost, __ATOMIC_ACQUIRE);
+}
+
+/* ============================================================================
+ * Frame Loop Side
+ * ============================================================================ */
+
+bool ncurses_input_thread_pop(TUI_InputQueued* out) {
+    size_t tail = __atomic_load_n(&g_tail, __ATOMIC_RELAXED);
+    if (tail == __atomic_load_n(&g_head, __ATOMIC_ACQUIRE)) return false;
+    *out = g_ring[tail & (INPUT_RING_SIZE - 1)];
+    __atomic_store_n(&g_tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+/* Consume a pending wake. A byte still in flight is waited for (the
+ * reader is inside write()), so it is drained here rather than left to
+ * end the next sleep early. */
+static void wake_clear(void) {
+    int state;
+    while ((state = __atomic_load_n(&g_wake_state, __ATOMIC_ACQUIRE)) == WAKE_WRITING) {
+        sched_yield();
+    }
+    if (state != WAKE_SENT) return;
+    char drain[16];
+    while (read(g_wake_pipe[0], drain, sizeof(drain)) > 0) { /* empty */ }
+    __atomic_store_n(&g_wake_state, WAKE_IDLE, __ATOMIC_RELEASE);
+}
+
+/* Sleep up to timeout_us (negative = until input), returning early when
+ * the reader queues input or extra_fd (-1 = none) becomes readable, which
+ * sets *extra_ready. Returns true if woken by input. */
+bool ncurses_input_thread_wait(long timeout_us, int extra_fd, bool* extra_ready) {
+    if (!g_thread_active) return false;
+
+    /* Input already pending: don't sleep, but still poll extra_fd so a
+     * resize arriving with it is not left for a later frame */
+    bool woken = __atomic_load_n(&g_wake_state, __ATOMIC_ACQUIRE) != WAKE_IDLE;
+    if (woken) timeout_us = 0;
+
+    fd_set rd;
+    FD_ZERO(&rd);
+    FD_SET(g_wake_pipe[0], &rd);
+    if (extra_fd >= 0) FD_SET(extra_fd, &rd);
+    int maxfd = extra_fd > g_wake_pipe[0] ? extra_fd : g_wake_pipe[0];
+    struct timeval tv = { .tv_sec = timeout_us / 1000000, .tv_usec = timeout_us % 1000000 };
+    if (select(maxfd + 1, &rd, NULL, NULL, timeout_us < 0 ? NULL : &tv) > 0) {
+        if (FD_ISSET(g_wake_pipe[0], &rd)) woken = true;
+        if (extra_fd >= 0 && FD_ISSET(extra_fd, &rd)) *extra_ready = true;
+    }
+
+    if (woken) wake_clear();
+    return woken;
+}
@@ -21,39 +21,387 @@
  * ncurses PANEL/WINDOW resources for surface entities. Called by
  * lifecycle observers and systems in ncurses_module.c.
  *
+ * Z-order is kept in a registry of heap-allocated slots (one per surface,
+ * referenced from TUI_DrawContext_Component.slot) sorted by z_order, then
+ * creation order. Creating, destroying, re-ordering or showing a surface
+ * only records the lowest registry index whose stacking may be wrong;
+ * ncurses_surface_restack() then raises the panels from that index up and
+ * leaves the deck alone on frames where nothing changed.
+ *
+ * The same registry drives occlusion: whenever layout, visibility or
+ * opacity changes, ncurses_surface_update_occlusion() subtracts the rects
+ * of visible opaque surfaces above each surface from its own rect, and
+ * rebuilds the per-cell hit index that maps mouse positions to surfaces.
+ * A change records the screen rects the surface left and now covers; only
+ * surfaces overlapping one of those are recomputed.
+ *
+ * Destroyed surfaces park their hidden WINDOW/PANEL (and sub-cell buffer)
+ * in a small pool keyed by size class; creating a surface of a similar
+ * size takes them back instead of calling newwin/new_panel.
+ *
  * No CELS component _id usage here -- all data is passed in by the
  * caller. Safe for any translation unit.
  */
 
 #ifdef CELS_HAS_ECS
 
+#include "../tui_internal.h"
 #include <cels_ncurses.h>
 #include <cels_ncurses_draw.h>
 #include <ncurses.h>
 #include <panel.h>
+#include <limits.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct TUI_SurfaceSlot {
+    PANEL* panel;
+    int z_order;
+    uint32_t seq;           /* Creation order: tie-break for equal z_order */
+    bool opaque;
+    TUI_Visibility visibility;
+    int visible_rect_count;
+    TUI_CellRect visible_rects[TUI_VISIBLE_RECTS_MAX];  /* Surface coordinates */
+    int shown_x, shown_y;   /* Pad offset last copied to the WINDOW (-1 = none) */
+    int shown_w, shown_h;   /* Viewport size of that copy */
+    TUI_CellRect occlusion_rect;    /* Screen rect the last occlusion pass saw */
+};
+
+/* ============================================================================
+ * Surface Pool
+ * ============================================================================
+ *
+ * Entries are matched by size class (width and height rounded up to a
+ * power of two), so a reused WINDOW needs at most a small wresize. The
+ * pool never grows past g_pool_cap; surfaces destroyed while it is full
+ * are freed as before. Once drained at window shutdown the pool is closed
+ * until the next window opens: late destroys free their surface directly
+ * instead of parking it where nothing would free it.
+ */
+
+#define SURFACE_POOL_DEFAULT_CAP 16
+
+typedef struct SurfacePoolEntry {
+    WINDOW* win;
+    PANEL* panel;
+    TUI_SubCellBuffer* subcell;   /* May be NULL */
+    int w_class, h_class;
+} SurfacePoolEntry;
+
+static SurfacePoolEntry* g_pool = NULL;
+static int g_pool_count = 0;
+static int g_pool_cap = SURFACE_POOL_DEFAULT_CAP;
+static NCurses_SurfacePoolStats g_pool_stats = {0};
+static bool g_pool_closed = false;
+
+static int size_class(int v) {
+    int c = 4;
+    while (c < v && c < (INT_MAX >> 1)) c <<= 1;
+    return c;
+}
+
+static bool pool_take(int w, int h, SurfacePoolEntry* out) {
+    int wc = size_class(w), hc = size_class(h);
+    for (int i = 0; i < g_pool_count; i++) {
+        if (g_pool[i].w_class != wc || g_pool[i].h_class != hc) continue;
+        *out = g_pool[i];
+        g_pool[i] = g_pool[--g_pool_count];
+        g_pool_stats.hits++;
+        return true;
+    }
+    g_pool_stats.misses++;
+    return false;
+}
+
+/* Park a surface's resources. Returns false if the pool is full (caller
+ * frees them). */
+static bool pool_give(WINDOW* win, PANEL* panel, TUI_SubCellBuffer* subcell) {
+    if (g_pool_closed) return false;
+    if (g_pool_count >= g_pool_cap) {
+        g_pool_stats.discarded++;
+        return false;
+    }
+    if (!g_pool) {
+        g_pool = malloc((size_t)g_pool_cap * sizeof(SurfacePoolEntry));
+        if (!g_pool) return false;
+    }
+
+    hide_panel(panel);
+    set_panel_userptr(panel, NULL);
+    werase(win);
+
+    int h, w;
+    getmaxyx(win, h, w);
+    g_pool[g_pool_count++] = (SurfacePoolEntry){
+        .win = win, .panel = panel, .subcell = subcell,
+        .w_class = size_class(w), .h_class = size_class(h)
+    };
+    g_pool_stats.recycled++;
+    return true;
+}
+
+static void pool_entry_free(SurfacePoolEntry* e) {
+    tui_subcell_buffer_destroy(e->subcell);
+    del_panel(e->panel);
+    delwin(e->win);
+}
+
+void ncurses_surface_pool_set_capacity(int capacity) {
+    if (capacity < 0) capacity = 0;
+    while (g_pool_count > capacity) {
+        pool_entry_free(&g_pool[--g_pool_count]);
+    }
+    if (capacity != g_pool_cap) {
+        SurfacePoolEntry* resized = NULL;
+        if (capacity > 0) {
+            resized = realloc(g_pool, (size_t)capacity * sizeof(SurfacePoolEntry));
+            if (!resized) return;
+        } else {
+            free(g_pool);
+        }
+        g_pool = resized;
+        g_pool_cap = capacity;
+    }
+}
+
+NCurses_SurfacePoolStats ncurses_surface_pool_stats(void) {
+    NCurses_SurfacePoolStats stats = g_pool_stats;
+    stats.pooled = g_pool_count;
+    stats.capacity = g_pool_cap;
+    return stats;
+}
+
+void ncurses_surface_pool_drain(void) {
+    g_pool_closed = true;
+    while (g_pool_count > 0) {
+        pool_entry_free(&g_pool[--g_pool_count]);
+    }
+}
+
+void ncurses_surface_pool_open(void) {
+    g_pool_closed = false;
+}
+
+/* ============================================================================
+ * Z-Order Registry
+ * ============================================================================ */
+
+static TUI_SurfaceSlot** g_slots = NULL;   /* Sorted by (z_order, seq) */
+static int g_slot_count = 0;
+static int g_slot_cap = 0;
+static uint32_t g_slot_seq = 0;
+static int g_restack_from = INT_MAX;        /* INT_MAX = deck is in order */
+static bool g_occlusion_dirty = true;
+static bool g_hit_dirty = true;
+
+/* Changed screen rects since the last occlusion pass; past the cap (or
+ * for a change with no known rect) every surface is recomputed */
+#define OCCLUSION_DIRTY_MAX 16
+static TUI_CellRect g_occlusion_dirty_rects[OCCLUSION_DIRTY_MAX];
+static int g_occlusion_dirty_count = 0;
+static bool g_occlusion_full = true;
+
+static TUI_CellRect slot_screen_rect(const TUI_SurfaceSlot* slot) {
+    WINDOW* win = panel_window(slot->panel);
+    int y, x, h, w;
+    getbegyx(win, y, x);
+    getmaxyx(win, h, w);
+    return (TUI_CellRect){ x, y, w, h };
+}
+
+/* Layout changed somewhere unknown: recompute every surface */
+static void mark_layout_dirty(void) {
+    g_occlusion_dirty = true;
+    g_occlusion_full = true;
+    g_hit_dirty = true;
+}
+
+static void mark_rect_dirty(TUI_CellRect r) {
+    if (r.w <= 0 || r.h <= 0) return;
+    if (g_occlusion_dirty_count == OCCLUSION_DIRTY_MAX) {
+        g_occlusion_full = true;
+        return;
+    }
+    g_occlusion_dirty_rects[g_occlusion_dirty_count++] = r;
+}
+
+/* Layout, visibility, opacity or stacking of slot changed: only surfaces
+ * overlapping where it was or where it is now can be affected */
+static void mark_slot_dirty(const TUI_SurfaceSlot* slot) {
+    g_occlusion_dirty = true;
+    g_hit_dirty = true;
+    mark_rect_dirty(slot->occlusion_rect);
+    if (slot->panel) mark_rect_dirty(slot_screen_rect(slot));
+}
+
+static bool slot_before(const TUI_SurfaceSlot* a, int z, uint32_t seq) {
+    return a->z_order < z || (a->z_order == z && a->seq < seq);
+}
+
+/* First index whose slot does not sort before (z, seq) */
+static int slot_lower_bound(int z, uint32_t seq) {
+    int lo = 0, hi = g_slot_count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (slot_before(g_slots[mid], z, seq)) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static void mark_restack(int index, const TUI_SurfaceSlot* slot) {
+    if (index < g_restack_from) g_restack_from = index;
+    mark_slot_dirty(slot);
+}
+
+static bool slot_insert(TUI_SurfaceSlot* slot) {
+    if (g_slot_count == g_slot_cap) {
+        int cap = g_slot_cap ? g_slot_cap * 2 : 32;
+        TUI_SurfaceSlot** grown = realloc(g_slots, (size_t)cap * sizeof(*grown));
+        if (!grown) return false;
+        g_slots = grown;
+        g_slot_cap = cap;
+    }
+    int pos = slot_lower_bound(slot->z_order, slot->seq);
+    memmove(&g_slots[pos + 1], &g_slots[pos],
+            (size_t)(g_slot_count - pos) * sizeof(*g_slots));
+    g_slots[pos] = slot;
+    g_slot_count++;
+    mark_restack(pos, slot);
+    return true;
+}
+
+/* Remove slot from the registry; returns its former index (-1 if absent) */
+static int slot_remove(TUI_SurfaceSlot* slot) {
+    int pos = slot_lower_bound(slot->z_order, slot->seq);
+    if (pos >= g_slot_count || g_slots[pos] != slot) return -1;
+    memmove(&g_slots[pos], &g_slots[pos + 1],
+            (size_t)(g_slot_count - pos - 1) * sizeof(*g_slots));
+    g_slot_count--;
+    mark_slot_dirty(slot);
+    return pos;
+}
+
+/* Target geometry for a surface: 0 width/height means the full terminal,
+ * and the position is clamped so the WINDOW stays on screen (ncurses
+ * refuses to place a window that extends past the screen edge). Layout
+ * follows the settled terminal size, capped by the real one so a surface
+ * created mid-resize still fits. */
+static void surface_target_rect(const TUI_SurfaceConfig* config,
+                                int* x, int* y, int* w, int* h) {
+    int cols, lines;
+    ncurses_window_layout_size(&cols, &lines);
+    if (cols > COLS) cols = COLS;
+    if (lines > LINES) lines = LINES;
+    *w = config->width > 0 ? config->width : cols;
+    *h = config->height > 0 ? config->height : lines;
+    *x = config->x;
+    *y = config->y;
+    if (*x > cols - *w) *x = cols - *w;
+    if (*y > lines - *h) *y = lines - *h;
+    if (*x < 0) *x = 0;
+    if (*y < 0) *y = 0;
+}
+
+/* Pad size for a virtual surface: the configured content size, but never
+ * smaller than the viewport so copywin() always has a full source rect */
+static void virtual_target_size(const TUI_SurfaceConfig* config, int view_w, int view_h,
+                                int* vw, int* vh) {
+    *vw = config->virtual_width > view_w ? config->virtual_width : view_w;
+    *vh = config->virtual_height > view_h ? config->virtual_height : view_h;
+}
+
+static bool surface_is_virtual(const TUI_SurfaceConfig* config) {
+    return config->virtual_width > 0 || config->virtual_height > 0;
+}
+
+static int clamp_scroll(int offset, int content, int view) {
+    if (offset > content - view) offset = content - view;
+    return offset < 0 ? 0 : offset;
+}
+
+/* Viewport size of a surface. For virtual surfaces ctx spans the pad, so
+ * the size comes from the WINDOW; otherwise from the context (see
+ * ncurses_surface_geometry_changed). */
+static void surface_size(const TUI_DrawContext_Component* dc, int* w, int* h) {
+    if (dc->pad) {
+        getmaxyx(dc->win, *h, *w);
+    } else {
+        *w = dc->ctx.width;
+        *h = dc->ctx.height;
+    }
+}
 
 TUI_DrawContext_Component ncurses_surface_panel_create(
     const TUI_SurfaceConfig* config, cels_entity_t entity)
 {
     TUI_DrawContext_Component dc = {0};
 
-    int w = config->width > 0 ? config->width : COLS;
-    int h = config->height > 0 ? config->height : LINES;
+    int x, y, w, h;
+    surface_target_rect(config, &x, &y, &w, &h);
 
-    WINDOW* win = newwin(h, w, config->y, config->x);
-    if (!win) return dc;
+    WINDOW* win;
+    PANEL* panel;
+    TUI_SubCellBuffer* subcell = NULL;
+    SurfacePoolEntry pooled;
+    bool reused = pool_take(w, h, &pooled);
 
-    PANEL* panel = new_panel(win);
-    if (!panel) {
-        delwin(win);
-        return dc;
+    if (reused) {
+        /* Pooled panels are hidden and erased; fit them to this surface */
+        win = pooled.win;
+        panel = pooled.panel;
+        subcell = pooled.subcell;
+        int cur_h, cur_w;
+        getmaxyx(win, cur_h, cur_w);
+        if (cur_w != w || cur_h != h) wresize(win, h, w);
+        move_panel(panel, y, x);
+        if (subcell) {
+            tui_subcell_buffer_resize(subcell, w, h);
+            tui_subcell_buffer_clear(subcell);
+        }
+    } else {
+        win = newwin(h, w, y, x);
+        if (!win) return dc;
+
+        panel = new_panel(win);
+        if (!panel) {
+            delwin(win);
+            return dc;
+        }
     }
 
     set_panel_userptr(panel, (void*)(uintptr_t)entity);
 
-    if (!config->visible) {
+    TUI_SurfaceSlot* slot = malloc(sizeof(TUI_SurfaceSlot));
+    if (!slot) {
+        tui_subcell_buffer_destroy(subcell);
+        del_panel(panel);
+        delwin(win);
+        return dc;
+    }
+    slot->panel = panel;
+    slot->z_order = config->z_order;
+    slot->seq = g_slot_seq++;
+    slot->opaque = config->opaque;
+    slot->visibility = TUI_VISIBILITY_FULL;
+    slot->visible_rect_count = 0;
+    slot->shown_x = -1;
+    slot->shown_y = -1;
+    slot->occlusion_rect = (TUI_CellRect){ 0, 0, 0, 0 };
+    if (!slot_insert(slot)) {
+        free(slot);
+        tui_subcell_buffer_destroy(subcell);
+        del_panel(panel);
+        delwin(win);
+        return dc;
+    }
+
+    /* new_panel() stacks the panel visibly; pooled panels come back hidden */
+    if (!reused && !config->visible) {
         hide_panel(panel);
+    } else if (reused && config->visible) {
+        show_panel(panel);
     }
 
     dc.ctx = tui_draw_context_create(win, 0, 0, w, h);
@@ -61,14 +409,59 @@ TUI_DrawContext_Component ncurses_surface_panel_create(
     dc.panel = panel;
     dc.win = win;
     dc.subcell_buf = NULL;
+    dc.slot = slot;
+
+    /* Virtual surfaces draw into a pad that outlives frames. Offscreen
+     * surfaces draw into a cell buffer (ctx.cells routes draws, and the
+     * buffer owns the sub-cell state so sub-cell drawing works from any
+     * thread). Retained surfaces record into a draw list. */
+    if (surface_is_virtual(config)) {
+        int vw, vh;
+        virtual_target_size(config, w, h, &vw, &vh);
+        dc.pad = newpad(vh, vw);
+        if (dc.pad) {
+            dc.ctx = tui_draw_context_create(dc.pad, 0, 0, vw, vh);
+            dc.scroll_x = clamp_scroll(config->scroll_x, vw, w);
+            dc.scroll_y = clamp_scroll(config->scroll_y, vh, h);
+        }
+    } else if (config->offscreen) {
+        dc.cell_buf = tui_cell_buffer_create(w, h);
+        if (dc.cell_buf) {
+            dc.cell_buf->subcell = subcell;
+            subcell = NULL;
+            dc.ctx.cells = dc.cell_buf;
+            dc.ctx.subcell_buf = &dc.cell_buf->subcell;
+        }
+    } else if (config->retained) {
+        dc.draw_list = tui_draw_list_create();
+        dc.ctx.list = dc.draw_list;
+    }
+    /* A pooled sub-cell buffer not adopted above stays with the surface */
+    dc.subcell_buf = subcell;
 
     return dc;
 }
 
 void ncurses_surface_panel_destroy(const TUI_DrawContext_Component* dc) {
-    if (dc->subcell_buf) {
-        tui_subcell_buffer_destroy(dc->subcell_buf);
+    /* Keep one sub-cell buffer for the pool (offscreen surfaces keep
+     * theirs inside the cell buffer) */
+    TUI_SubCellBuffer* subcell = dc->subcell_buf;
+    if (dc->cell_buf) {
+        if (!subcell) subcell = dc->cell_buf->subcell;
+        else tui_subcell_buffer_destroy(dc->cell_buf->subcell);
+        dc->cell_buf->subcell = NULL;
     }
+    tui_draw_list_destroy(dc->draw_list);
+    tui_cell_buffer_destroy(dc->cell_buf);
+    if (dc->pad) delwin(dc->pad);
+    /* del_panel unlinks the panel; the remaining deck order is unchanged */
+    if (dc->slot) {
+        slot_remove(dc->slot);
+        free(dc->slot);
+    }
+    if (dc->panel && dc->win && pool_give(dc->win, dc->panel, subcell)) return;
+
+    tui_subcell_buffer_destroy(subcell);
     if (dc->panel) del_panel(dc->panel);
     if (dc->win) delwin(dc->win);
 }
@@ -76,25 +469,384 @@ void ncurses_surface_panel_destroy(const TUI_DrawContext_Component* dc) {
 void ncurses_surface_panel_resize(TUI_DrawContext_Component* dc, int new_w, int new_h) {
     if (!dc || !dc->win || !dc->panel) return;
 
+    /* resizeterm() refits fullscreen and edge windows itself, dropping
+     * whatever it cropped: the draw list must replay in full */
+    int cur_h, cur_w;
+    getmaxyx(dc->win, cur_h, cur_w);
+    if (cur_w != dc->ctx.width || cur_h != dc->ctx.height) {
+        tui_draw_list_invalidate(dc->draw_list);
+    }
+
+    /* wresize keeps the cells that still fit; only new area is blank */
     wresize(dc->win, new_h, new_w);
     replace_panel(dc->panel, dc->win);
-    werase(dc->win);
+    if (dc->slot) mark_slot_dirty(dc->slot);
+    else mark_layout_dirty();
+
+    /* Virtual surfaces keep drawing into the pad; grow it if the viewport
+     * outgrew it, and recopy the viewport at the next commit */
+    if (dc->pad) {
+        int pad_h, pad_w;
+        getmaxyx(dc->pad, pad_h, pad_w);
+        if (new_w > pad_w || new_h > pad_h) {
+            if (new_w > pad_w) pad_w = new_w;
+            if (new_h > pad_h) pad_h = new_h;
+            wresize(dc->pad, pad_h, pad_w);
+            dc->ctx = tui_draw_context_create(dc->pad, 0, 0, pad_w, pad_h);
+        }
+        dc->scroll_x = clamp_scroll(dc->scroll_x, pad_w, new_w);
+        dc->scroll_y = clamp_scroll(dc->scroll_y, pad_h, new_h);
+        if (dc->slot) dc->slot->shown_x = -1;
+        dc->dirty = true;
+        return;
+    }
 
     dc->ctx = tui_draw_context_create(dc->win, 0, 0, new_w, new_h);
+    dc->ctx.list = dc->draw_list;
     dc->dirty = true;
 
+    if (dc->cell_buf) {
+        tui_cell_buffer_resize(dc->cell_buf, new_w, new_h);
+        dc->ctx.cells = dc->cell_buf;
+        dc->ctx.subcell_buf = &dc->cell_buf->subcell;
+    }
+
     if (dc->subcell_buf) {
         tui_subcell_buffer_resize(dc->subcell_buf, new_w, new_h);
     }
 }
 
-void ncurses_surface_sync_visibility(bool visible, PANEL* panel) {
-    if (!panel) return;
-    if (visible && panel_hidden(panel)) {
-        show_panel(panel);
-    } else if (!visible && !panel_hidden(panel)) {
-        hide_panel(panel);
+bool ncurses_surface_geometry_changed(const TUI_SurfaceConfig* config,
+                                      const TUI_DrawContext_Component* dc) {
+    if (!config || !dc || !dc->win) return false;
+    int x, y, w, h, cur_x, cur_y, cur_w, cur_h;
+    surface_target_rect(config, &x, &y, &w, &h);
+    getbegyx(dc->win, cur_y, cur_x);
+    /* Size is compared against the context, not the WINDOW: resizeterm()
+     * may already have refit the WINDOW, but the context and buffers
+     * still have the old size */
+    surface_size(dc, &cur_w, &cur_h);
+    return x != cur_x || y != cur_y || w != cur_w || h != cur_h;
+}
+
+/* Bring the WINDOW to the configured rect: wresize in place when the size
+ * changed, move_panel when the position changed. Nothing is reallocated
+ * for a pure move. */
+void ncurses_surface_apply_geometry(TUI_DrawContext_Component* dc,
+                                    const TUI_SurfaceConfig* config) {
+    if (!config || !dc || !dc->win || !dc->panel) return;
+    int x, y, w, h, cur_x, cur_y, cur_w, cur_h;
+    surface_target_rect(config, &x, &y, &w, &h);
+    getbegyx(dc->win, cur_y, cur_x);
+    surface_size(dc, &cur_w, &cur_h);
+
+    if (w != cur_w || h != cur_h) {
+        ncurses_surface_panel_resize(dc, w, h);
+    }
+    if (x != cur_x || y != cur_y) {
+        move_panel(dc->panel, y, x);
+        if (dc->slot) mark_slot_dirty(dc->slot);
+        else mark_layout_dirty();
+    }
+}
+
+bool ncurses_surface_virtual_changed(const TUI_SurfaceConfig* config,
+                                     const TUI_DrawContext_Component* dc) {
+    if (!config || !dc || !dc->pad) return false;
+    int view_h, view_w, vw, vh;
+    getmaxyx(dc->win, view_h, view_w);
+    virtual_target_size(config, view_w, view_h, &vw, &vh);
+    return vw != dc->ctx.width || vh != dc->ctx.height
+        || clamp_scroll(config->scroll_x, vw, view_w) != dc->scroll_x
+        || clamp_scroll(config->scroll_y, vh, view_h) != dc->scroll_y;
+}
+
+/* Follow virtual size and scroll offset changes. The pad is resized in
+ * place (content that still fits is kept); a scroll only updates the
+ * offset, and the next commit copies the new part of the pad. */
+void ncurses_surface_apply_virtual(TUI_DrawContext_Component* dc,
+                                   const TUI_SurfaceConfig* config) {
+    if (!config || !dc || !dc->pad) return;
+    int view_h, view_w, vw, vh;
+    getmaxyx(dc->win, view_h, view_w);
+    virtual_target_size(config, view_w, view_h, &vw, &vh);
+
+    if (vw != dc->ctx.width || vh != dc->ctx.height) {
+        wresize(dc->pad, vh, vw);
+        dc->ctx = tui_draw_context_create(dc->pad, 0, 0, vw, vh);
+        dc->dirty = true;
+    }
+    dc->scroll_x = clamp_scroll(config->scroll_x, vw, view_w);
+    dc->scroll_y = clamp_scroll(config->scroll_y, vh, view_h);
+}
+
+void ncurses_surface_sync_visibility(bool visible, TUI_SurfaceSlot* slot) {
+    if (!slot || !slot->panel) return;
+    if (visible && panel_hidden(slot->panel)) {
+        /* show_panel puts the panel on top -- restack from its position */
+        show_panel(slot->panel);
+        mark_restack(slot_lower_bound(slot->z_order, slot->seq), slot);
+    } else if (!visible && !panel_hidden(slot->panel)) {
+        hide_panel(slot->panel);
+        mark_slot_dirty(slot);
+    }
+}
+
+void ncurses_surface_set_opaque(TUI_SurfaceSlot* slot, bool opaque) {
+    if (!slot || slot->opaque == opaque) return;
+    slot->opaque = opaque;
+    mark_slot_dirty(slot);
+}
+
+void ncurses_surface_set_z_order(TUI_SurfaceSlot* slot, int z_order) {
+    if (!slot || slot->z_order == z_order) return;
+    int old_pos = slot_remove(slot);
+    slot->z_order = z_order;
+    if (old_pos >= 0) mark_restack(old_pos, slot);
+    slot_insert(slot);
+}
+
+/* Raise every visible panel from the first out-of-order registry index
+ * upward, in ascending z. Panels below that index are already stacked
+ * correctly beneath them. Hidden panels are skipped: top_panel() would
+ * show them. */
+void ncurses_surface_restack(void) {
+    if (g_restack_from >= g_slot_count) {
+        g_restack_from = INT_MAX;
+        return;
+    }
+    for (int i = g_restack_from; i < g_slot_count; i++) {
+        PANEL* panel = g_slots[i]->panel;
+        if (panel && !panel_hidden(panel)) top_panel(panel);
+    }
+    g_restack_from = INT_MAX;
+}
+
+/* ============================================================================
+ * Occlusion
+ * ============================================================================ */
+
+/* a minus b as up to 4 disjoint rects (top, bottom, left, right bands) */
+static int rect_subtract(TUI_CellRect a, TUI_CellRect b, TUI_CellRect out[4]) {
+    TUI_CellRect i = tui_cell_rect_intersect(a, b);
+    if (i.w <= 0 || i.h <= 0) {
+        out[0] = a;
+        return 1;
+    }
+    int n = 0;
+    if (i.y > a.y) {
+        out[n++] = (TUI_CellRect){ a.x, a.y, a.w, i.y - a.y };
+    }
+    if (i.y + i.h < a.y + a.h) {
+        out[n++] = (TUI_CellRect){ a.x, i.y + i.h, a.w, a.y + a.h - (i.y + i.h) };
+    }
+    if (i.x > a.x) {
+        out[n++] = (TUI_CellRect){ a.x, i.y, i.x - a.x, i.h };
+    }
+    if (i.x + i.w < a.x + a.w) {
+        out[n++] = (TUI_CellRect){ i.x + i.w, i.y, a.x + a.w - (i.x + i.w), i.h };
+    }
+    return n;
+}
+
+static void slot_compute_visibility(int index) {
+    TUI_SurfaceSlot* slot = g_slots[index];
+    if (!slot->panel || panel_hidden(slot->panel)) {
+        slot->visibility = TUI_VISIBILITY_OCCLUDED;
+        slot->visible_rect_count = 0;
+        return;
+    }
+
+    TUI_CellRect self = slot_screen_rect(slot);
+    TUI_CellRect rects[TUI_VISIBLE_RECTS_MAX];
+    int count = 1;
+    rects[0] = self;
+    bool covered = false;
+
+    for (int j = index + 1; j < g_slot_count && count > 0; j++) {
+        const TUI_SurfaceSlot* above = g_slots[j];
+        if (!above->opaque || !above->panel || panel_hidden(above->panel)) continue;
+        TUI_CellRect occluder = slot_screen_rect(above);
+
+        TUI_CellRect next[TUI_VISIBLE_RECTS_MAX];
+        int next_count = 0;
+        bool hit = false;
+        bool overflow = false;
+        for (int r = 0; r < count; r++) {
+            TUI_CellRect i = tui_cell_rect_intersect(rects[r], occluder);
+            if (i.w > 0 && i.h > 0) hit = true;
+
+            TUI_CellRect pieces[4];
+            int n = rect_subtract(rects[r], occluder, pieces);
+            if (next_count + n > TUI_VISIBLE_RECTS_MAX) {
+                overflow = true;
+                break;
+            }
+            for (int p = 0; p < n; p++) next[next_count++] = pieces[p];
+        }
+        /* Too many pieces: keep the coarser (conservative) result */
+        if (overflow || !hit) continue;
+        covered = true;
+        memcpy(rects, next, (size_t)next_count * sizeof(TUI_CellRect));
+        count = next_count;
+    }
+
+    if (count == 0) {
+        slot->visibility = TUI_VISIBILITY_OCCLUDED;
+        slot->visible_rect_count = 0;
+        return;
+    }
+    if (!covered) {
+        slot->visibility = TUI_VISIBILITY_FULL;
+        slot->visible_rect_count = 0;
+        return;
+    }
+
+    slot->visibility = TUI_VISIBILITY_PARTIAL;
+    slot->visible_rect_count = count;
+    for (int r = 0; r < count; r++) {
+        slot->visible_rects[r] = (TUI_CellRect){
+            rects[r].x - self.x, rects[r].y - self.y, rects[r].w, rects[r].h
+        };
+    }
+}
+
+static bool rect_touches_dirty(TUI_CellRect r) {
+    for (int i = 0; i < g_occlusion_dirty_count; i++) {
+        TUI_CellRect o = tui_cell_rect_intersect(r, g_occlusion_dirty_rects[i]);
+        if (o.w > 0 && o.h > 0) return true;
     }
+    return false;
+}
+
+static void hit_index_rebuild(void);
+
+void ncurses_surface_update_occlusion(void) {
+    if (g_hit_dirty) hit_index_rebuild();
+    if (!g_occlusion_dirty) return;
+    for (int i = 0; i < g_slot_count; i++) {
+        TUI_SurfaceSlot* slot = g_slots[i];
+        TUI_CellRect now = slot->panel ? slot_screen_rect(slot)
+                                       : (TUI_CellRect){ 0, 0, 0, 0 };
+        /* Occluders only changed inside the dirty rects: a surface clear
+         * of all of them keeps its result */
+        if (!g_occlusion_full && !rect_touches_dirty(now)) continue;
+        slot_compute_visibility(i);
+        slot->occlusion_rect = now;
+    }
+    g_occlusion_dirty = false;
+    g_occlusion_full = false;
+    g_occlusion_dirty_count = 0;
+}
+
+/* Copy the slot's occlusion result into the component and narrow the
+ * context clip (and scissor base) to the visible bounding box. Persistent
+ * surfaces are never cleared, so cells skipped while covered would stay
+ * stale once uncovered: they keep the full clip. */
+void ncurses_surface_apply_occlusion(TUI_DrawContext_Component* dc, bool persistent) {
+    if (!dc || !dc->slot) return;
+    const TUI_SurfaceSlot* slot = dc->slot;
+
+    dc->visibility = slot->visibility;
+    dc->visible_rect_count = slot->visible_rect_count;
+    memcpy(dc->visible_rects, slot->visible_rects,
+           (size_t)slot->visible_rect_count * sizeof(TUI_CellRect));
+
+    TUI_CellRect clip = { dc->ctx.x, dc->ctx.y, dc->ctx.width, dc->ctx.height };
+    if (dc->pad) {
+        /* Pad content outlives the current viewport and occluders: never
+         * narrow it (an OCCLUDED viewport is just not copied) */
+        dc->ctx.clip = clip;
+        dc->ctx.scissor.rects[0] = clip;
+        dc->ctx.scissor.sp = 0;
+        return;
+    }
+    if (!persistent && slot->visibility == TUI_VISIBILITY_OCCLUDED) {
+        clip = (TUI_CellRect){ 0, 0, 0, 0 };
+    } else if (!persistent && slot->visibility == TUI_VISIBILITY_PARTIAL) {
+        int x0 = INT_MAX, y0 = INT_MAX, x1 = INT_MIN, y1 = INT_MIN;
+        for (int r = 0; r < slot->visible_rect_count; r++) {
+            const TUI_CellRect* v = &slot->visible_rects[r];
+            if (v->x < x0) x0 = v->x;
+            if (v->y < y0) y0 = v->y;
+            if (v->x + v->w > x1) x1 = v->x + v->w;
+            if (v->y + v->h > y1) y1 = v->y + v->h;
+        }
+        clip = (TUI_CellRect){ x0, y0, x1 - x0, y1 - y0 };
+    }
+
+    /* While a terminal resize settles the WINDOW may be smaller than the
+     * context: crop drawing to what is actually there */
+    int win_h = 0, win_w = 0;
+    if (dc->win) getmaxyx(dc->win, win_h, win_w);
+    if (dc->win && (win_w < dc->ctx.width || win_h < dc->ctx.height)) {
+        clip = tui_cell_rect_intersect(clip, (TUI_CellRect){ 0, 0, win_w, win_h });
+    }
+    dc->ctx.clip = clip;
+    dc->ctx.scissor.rects[0] = clip;
+    dc->ctx.scissor.sp = 0;
+}
+
+/* ============================================================================
+ * Hit Testing
+ * ============================================================================
+ *
+ * One entry per terminal cell holding the registry index (+1, 0 = no
+ * surface) of the topmost visible surface covering it. Rebuilt with the
+ * occlusion pass when layout, visibility or stacking changed, by painting
+ * the visible slots' rects bottom to top. Transparency does not matter
+ * here: a panel owns every cell of its rect. A lookup is one array read
+ * plus the panel's origin.
+ */
+
+static int* g_hit_grid = NULL;
+static int g_hit_cols = 0;
+static int g_hit_lines = 0;
+
+static void hit_index_rebuild(void) {
+    g_hit_dirty = false;
+    size_t cells = (size_t)COLS * (size_t)LINES;
+    if (!g_hit_grid || COLS != g_hit_cols || LINES != g_hit_lines) {
+        int* grid = realloc(g_hit_grid, (cells ? cells : 1) * sizeof(*grid));
+        if (!grid) {
+            g_hit_cols = g_hit_lines = 0;
+            return;
+        }
+        g_hit_grid = grid;
+        g_hit_cols = COLS;
+        g_hit_lines = LINES;
+    }
+    memset(g_hit_grid, 0, cells * sizeof(*g_hit_grid));
+
+    TUI_CellRect screen = { 0, 0, g_hit_cols, g_hit_lines };
+    for (int i = 0; i < g_slot_count; i++) {
+        const TUI_SurfaceSlot* slot = g_slots[i];
+        if (!slot->panel || panel_hidden(slot->panel)) continue;
+        TUI_CellRect r = tui_cell_rect_intersect(slot_screen_rect(slot), screen);
+        for (int y = r.y; y < r.y + r.h; y++) {
+            int* row = &g_hit_grid[(size_t)y * (size_t)g_hit_cols];
+            for (int x = r.x; x < r.x + r.w; x++) row[x] = i + 1;
+        }
+    }
+}
+
+NCurses_SurfaceHit ncurses_surface_hit_test(int x, int y) {
+    NCurses_SurfaceHit hit = { 0, x, y };
+    /* Surfaces changed since the last TUI_SurfaceSystem (or the terminal
+     * was resized): the grid may name freed slots, so refresh it first */
+    if (g_hit_dirty || COLS != g_hit_cols || LINES != g_hit_lines) hit_index_rebuild();
+    if (x < 0 || y < 0 || x >= g_hit_cols || y >= g_hit_lines) return hit;
+
+    int index = g_hit_grid[(size_t)y * (size_t)g_hit_cols + (size_t)x] - 1;
+    if (index < 0 || index >= g_slot_count) return hit;
+
+    PANEL* panel = g_slots[index]->panel;
+    int top, left;
+    getbegyx(panel_window(panel), top, left);
+    hit.entity = (cels_entity_t)(uintptr_t)panel_userptr(panel);
+    hit.x = x - left;
+    hit.y = y - top;
+    return hit;
 }
 
 void ncurses_surface_clear_window(WINDOW* win, TUI_SubCellBuffer* subcell_buf) {
@@ -106,30 +858,80 @@ void ncurses_surface_clear_window(WINDOW* win, TUI_SubCellBuffer* subcell_buf) {
     }
 }
 
-void ncurses_surface_sort_and_stack(PANEL** panels, int* z_orders, int count) {
-    if (count <= 1) {
-        if (count == 1 && panels[0]) top_panel(panels[0]);
-        return;
+/* Copy the viewport of a virtual surface out of its pad if the pad was
+ * drawn to or the viewport moved since the last copy */
+static void commit_virtual(TUI_DrawContext_Component* dc) {
+    TUI_SurfaceSlot* slot = dc->slot;
+    int view_h, view_w, pad_h, pad_w;
+    getmaxyx(dc->win, view_h, view_w);
+    getmaxyx(dc->pad, pad_h, pad_w);
+
+    bool moved = !slot || slot->shown_x != dc->scroll_x || slot->shown_y != dc->scroll_y
+              || slot->shown_w != view_w || slot->shown_h != view_h;
+    if (!moved && !is_wintouched(dc->pad)) return;
+
+    /* Source rect must lie inside the pad (the WINDOW may have been refit
+     * by resizeterm() ahead of the pad) */
+    int w = view_w, h = view_h;
+    if (w > pad_w - dc->scroll_x) w = pad_w - dc->scroll_x;
+    if (h > pad_h - dc->scroll_y) h = pad_h - dc->scroll_y;
+    if (w <= 0 || h <= 0) return;
+
+    copywin(dc->pad, dc->win, dc->scroll_y, dc->scroll_x, 0, 0, h - 1, w - 1, FALSE);
+    untouchwin(dc->pad);
+    if (slot) {
+        slot->shown_x = dc->scroll_x;
+        slot->shown_y = dc->scroll_y;
+        slot->shown_w = view_w;
+        slot->shown_h = view_h;
     }
+}
 
-    /* Insertion sort by z_order ascending (max 32 entries) */
-    for (int i = 1; i < count; i++) {
-        PANEL* kp = panels[i];
-        int kz = z_orders[i];
-        int j = i - 1;
-        while (j >= 0 && z_orders[j] > kz) {
-            panels[j + 1] = panels[j];
-            z_orders[j + 1] = z_orders[j];
-            j--;
-        }
-        panels[j + 1] = kp;
-        z_orders[j + 1] = kz;
+/* Copy an offscreen surface's cell buffer into its WINDOW, copy a virtual
+ * surface's viewport out of its pad, or replay a retained surface's draw
+ * list if the recorded content changed since the last commit. Unchanged
+ * lists leave the WINDOW (and therefore ncurses' change tracking)
+ * untouched. */
+void ncurses_surface_commit(TUI_DrawContext_Component* dc) {
+    if (!dc || !dc->win) return;
+    if (dc->pad) {
+        commit_virtual(dc);
+        return;
     }
+    if (dc->cell_buf) {
+        tui_cell_buffer_commit(dc->cell_buf, dc->win);
+        return;
+    }
+    if (!dc->draw_list) return;
+    if (!tui_draw_list_changed(dc->draw_list)) return;
+
+    ncurses_surface_clear_window(dc->win, dc->subcell_buf);
+    TUI_DrawContext target = dc->ctx;
+    target.list = NULL;
+    tui_draw_list_replay(dc->draw_list, &target);
+}
+
+/* ============================================================================
+ * Scrolling
+ * ============================================================================ */
+
+void tui_surface_scroll(TUI_DrawContext_Component* dc, int dy) {
+    if (!dc || !dc->win || dy == 0) return;
 
-    /* Rebuild panel stack: top_panel in ascending z_order */
-    for (int i = 0; i < count; i++) {
-        if (panels[i]) top_panel(panels[i]);
+    /* Full-width panes may use the terminal's scroll region / insdel line */
+    idlok(dc->win, getmaxx(dc->win) == COLS);
+
+    if (dc->cell_buf) {
+        tui_cell_buffer_scroll(dc->cell_buf, dy);
+        return;
     }
+
+    WINDOW* target = dc->pad ? dc->pad : dc->win;
+    scrollok(target, TRUE);
+    wscrl(target, dy);
+    scrollok(target, FALSE);
+    tui_subcell_buffer_scroll(dc->subcell_buf, dy);
+    tui_draw_list_invalidate(dc->draw_list);
 }
 
 #endif /* CELS_HAS_ECS */
@@ -54,11 +54,13 @@ CEL_Observe(NCursesWindowLC, on_create) {
         return;
     }
 
+    ncurses_surface_pool_open();
     ncurses_terminal_init((NCurses_WindowConfig*)config);
 }
 
 CEL_Observe(NCursesWindowLC, on_destroy) {
     (void)entity;
+    ncurses_surface_pool_drain();
     ncurses_terminal_shutdown();
     ncurses_window_set_entity(0);
 }
@@ -88,54 +90,107 @@ CEL_Observe(TUI_SurfaceLC, on_destroy) {
 }
 
 /* ============================================================================
- * Surface System -- clears, syncs visibility, rebuilds z-order stack
+ * Surface System -- syncs size, visibility and z-order, restacks panels
  * ============================================================================ */
 
-#define TUI_SURFACE_MAX 32
-
 CEL_System(TUI_SurfaceSystem, .phase = PreRender) {
-    static int prev_cols = 0;
-    static int prev_lines = 0;
-
-    bool resized = (COLS != prev_cols || LINES != prev_lines) &&
-                   (prev_cols > 0 || prev_lines > 0);
-    prev_cols = COLS;
-    prev_lines = LINES;
-
-    PANEL* panels[TUI_SURFACE_MAX];
-    int z_orders[TUI_SURFACE_MAX];
-    int count = 0;
-
     cel_query(TUI_SurfaceConfig, TUI_DrawContext_Component);
     cel_each(TUI_SurfaceConfig, TUI_DrawContext_Component) {
-        /* Resize fullscreen entity layers when terminal dimensions changed */
-        if (resized &&
-            (TUI_SurfaceConfig->width == 0 || TUI_SurfaceConfig->height == 0)) {
-            int new_w = TUI_SurfaceConfig->width == 0 ? COLS : TUI_SurfaceConfig->width;
-            int new_h = TUI_SurfaceConfig->height == 0 ? LINES : TUI_SurfaceConfig->height;
+        /* Follow x/y/width/height changes (and terminal resizes for
+         * fullscreen surfaces): move_panel for moves, in-place resize
+         * for size changes. Held while a terminal resize is settling. */
+        if (!ncurses_window_resize_pending()
+            && ncurses_surface_geometry_changed(TUI_SurfaceConfig,
+                                                TUI_DrawContext_Component)) {
             cel_update(TUI_DrawContext_Component) {
-                ncurses_surface_panel_resize(TUI_DrawContext_Component, new_w, new_h);
+                ncurses_surface_apply_geometry(TUI_DrawContext_Component,
+                                               TUI_SurfaceConfig);
             }
         }
 
+        /* Virtual surfaces: pad size and scroll offset (copied at commit) */
+        if (ncurses_surface_virtual_changed(TUI_SurfaceConfig,
+                                            TUI_DrawContext_Component)) {
+            cel_update(TUI_DrawContext_Component) {
+                ncurses_surface_apply_virtual(TUI_DrawContext_Component,
+                                              TUI_SurfaceConfig);
+            }
+        }
+
+        ncurses_surface_set_z_order(
+            TUI_DrawContext_Component->slot, TUI_SurfaceConfig->z_order);
         ncurses_surface_sync_visibility(
-            TUI_SurfaceConfig->visible, TUI_DrawContext_Component->panel);
+            TUI_SurfaceConfig->visible, TUI_DrawContext_Component->slot);
+        ncurses_surface_set_opaque(
+            TUI_DrawContext_Component->slot, TUI_SurfaceConfig->opaque);
+    }
 
-        /* Auto-clear visible layers (developer gets blank canvas at OnRender) */
-        if (TUI_SurfaceConfig->visible) {
+    /* Touches the panel deck only if the order changed this frame;
+     * occlusion is recomputed only if layout or opacity changed */
+    ncurses_surface_restack();
+    ncurses_surface_update_occlusion();
+}
+
+/* ============================================================================
+ * Occlusion System -- publishes visibility, clears surfaces for OnRender
+ * ============================================================================
+ *
+ * Runs right after TUI_SurfaceSystem. Copies each surface's occlusion
+ * result into its component (narrowing ctx.clip) and gives visible
+ * surfaces a blank canvas. Fully occluded windows are not cleared: nothing
+ * of them reaches the screen.
+ */
+
+CEL_System(TUI_OcclusionSystem, .phase = PreRender) {
+    cel_query(TUI_SurfaceConfig, TUI_DrawContext_Component);
+    cel_each(TUI_SurfaceConfig, TUI_DrawContext_Component) {
+        cel_update(TUI_DrawContext_Component) {
+            ncurses_surface_apply_occlusion(
+                TUI_DrawContext_Component,
+                TUI_SurfaceConfig->persistent && !TUI_DrawContext_Component->draw_list);
+        }
+
+        /* Auto-clear visible layers (developer gets blank canvas at OnRender).
+         * Retained surfaces start a fresh recording instead; their WINDOW
+         * is only cleared at commit if the recorded content changed.
+         * Virtual and persistent surfaces keep their content across frames. */
+        if (TUI_DrawContext_Component->pad) continue;
+        if (TUI_SurfaceConfig->persistent && !TUI_DrawContext_Component->draw_list) continue;
+        if (TUI_DrawContext_Component->cell_buf) {
+            tui_cell_buffer_clear(TUI_DrawContext_Component->cell_buf);
+        } else if (TUI_DrawContext_Component->draw_list) {
+            tui_draw_list_begin(TUI_DrawContext_Component->draw_list);
+        } else if (TUI_SurfaceConfig->visible
+                   && TUI_DrawContext_Component->visibility != TUI_VISIBILITY_OCCLUDED) {
             ncurses_surface_clear_window(
                 TUI_DrawContext_Component->win,
                 TUI_DrawContext_Component->subcell_buf);
         }
-
-        if (count < TUI_SURFACE_MAX && TUI_DrawContext_Component->panel) {
-            panels[count] = TUI_DrawContext_Component->panel;
-            z_orders[count] = TUI_SurfaceConfig->z_order;
-            count++;
-        }
     }
+}
+
+/* ============================================================================
+ * Surface Commit System -- serialized ncurses writes before compositing
+ * ============================================================================
+ *
+ * Runs at PostRender ahead of TUI_FrameEndSystem, on the ncurses thread.
+ * Offscreen surfaces copy their cell buffers into their WINDOWs. Retained
+ * surfaces whose draw list is unchanged since the last replay are skipped.
+ * While paused or detached nothing is committed; the next frame after
+ * resuming is.
+ */
 
-    ncurses_surface_sort_and_stack(panels, z_orders, count);
+CEL_System(TUI_SurfaceCommitSystem, .phase = PostRender) {
+    cel_query(TUI_SurfaceConfig, TUI_DrawContext_Component);
+    cel_each(TUI_SurfaceConfig, TUI_DrawContext_Component) {
+        if (ncurses_window_is_paused() || ncurses_session_detached()) continue;
+        if (!TUI_SurfaceConfig->visible) continue;
+        if (TUI_DrawContext_Component->visibility == TUI_VISIBILITY_OCCLUDED) continue;
+        if (!TUI_DrawContext_Component->draw_list
+            && !TUI_DrawContext_Component->cell_buf
+            && !TUI_DrawContext_Component->pad) continue;
+        ncurses_surface_commit(TUI_DrawContext_Component);
+    }
 }
 
 /* ============================================================================
@@ -153,12 +208,25 @@ CEL_System(TUI_FrameBeginSystem, .phase = PreRender) {
 
 /* ============================================================================
  * Frame End System -- composites panels, flushes to terminal, unblocks SIGWINCH
- * ============================================================================ */
+ * ============================================================================
+ *
+ * Nothing is flushed while paused (F1), so the terminal keeps showing the
+ * frozen frame for selection, or while a headless session has no client.
+ * The latency tracer is stamped right after doupdate() returns.
+ */
 
 CEL_System(TUI_FrameEndSystem, .phase = PostRender) {
     cel_run {
-        update_panels();
-        doupdate();
+        /* Pipelined output: if the writer thread is still sending the
+         * previous frame, drop this one. ncurses keeps the pending changes
+         * and the next doupdate() emits them. */
+        bool flushed = !ncurses_window_is_paused() && !ncurses_output_pipeline_busy()
+                    && !ncurses_session_detached();
+        if (flushed) {
+            update_panels();
+            doupdate();
+        }
+        ncurses_latency_frame_end(flushed);
 
         sigset_t winch_set;
         sigemptyset(&winch_set);
@@ -174,12 +242,13 @@ CEL_System(TUI_FrameEndSystem, .phase = PostRender) {
  * ============================================================================ */
 
 CEL_Module(NCurses, init) {
-    cels_register(NCurses_WindowState, NCurses_InputState,
+    cels_register(NCurses_WindowState, NCurses_InputState, NCurses_LatencyState,
                   NCursesWindowLC, NCurses_WindowUpdateSystem,
                   TUI_Renderable, TUI_SurfaceConfig, TUI_DrawContext_Component,
                   TUI_SurfaceLC);
-    cels_register(TUI_SurfaceSystem, NCurses_InputSystem,
-                  TUI_FrameBeginSystem, TUI_FrameEndSystem);
+    cels_register(TUI_SurfaceSystem, TUI_OcclusionSystem, NCurses_InputSystem,
+                  TUI_FrameBeginSystem, TUI_SurfaceCommitSystem,
+                  TUI_FrameEndSystem);
 }
 
 /* ============================================================================
@@ -190,7 +259,13 @@ CEL_Composition(NCursesWindow) {
     cel_has(NCurses_WindowConfig,
         .title = cel.title,
         .fps = cel.fps,
-        .color_mode = cel.color_mode
+        .color_mode = cel.color_mode,
+        .pipelined = cel.pipelined,
+        .resize_debounce_ms = cel.resize_debounce_ms,
+        .mouse_motion = cel.mouse_motion,
+        .raw_input = cel.raw_input,
+        .input_thread = cel.input_thread,
+        .paused_fps = cel.paused_fps
     );
     cels_lifecycle_bind_entity(NCursesWindowLC_id, cels_get_current_entity());
 }
@@ -203,7 +278,15 @@ CEL_Composition(TUISurface) {
         .x = cel.x,
         .y = cel.y,
         .width = cel.width,
-        .height = cel.height
+        .height = cel.height,
+        .retained = cel.retained,
+        .offscreen = cel.offscreen,
+        .opaque = cel.opaque,
+        .virtual_width = cel.virtual_width,
+        .virtual_height = cel.virtual_height,
+        .scroll_x = cel.scroll_x,
+        .scroll_y = cel.scroll_y,
+        .persistent = cel.persistent
     );
     cels_lifecycle_bind_entity(TUI_SurfaceLC_id, cels_get_current_entity());
 }
@@ -40,24 +40,124 @@ extern void ncurses_terminal_shutdown(void);
 extern void ncurses_window_set_entity(cels_entity_t entity);
 extern cels_entity_t ncurses_window_get_entity(void);
 extern bool ncurses_window_is_active(void);
+extern void ncurses_window_set_paused(bool paused);
+extern bool ncurses_window_is_paused(void);
+extern void ncurses_window_layout_size(int* cols, int* lines);
+extern bool ncurses_window_resize_pending(void);
+extern void ncurses_terminal_send(const char* seq);
 
 /* ECS systems -- defined in source files, registered by module */
 CEL_Define_System(NCurses_InputSystem);
 CEL_Define_System(NCurses_WindowUpdateSystem);
 
 /* Input terminal config (key sequences, mouse) -- called after initscr/newterm */
-extern void ncurses_input_configure_terminal(void);
+extern void ncurses_input_configure_terminal(const NCurses_WindowConfig* config);
+extern void ncurses_input_restore_terminal(void);
+extern void ncurses_input_resend_modes(void);
+extern int ncurses_window_input_fd(void);
+
+/* Custom key codes for Ctrl+Arrow (above KEY_MAX, below INT_MAX) */
+#define CELS_KEY_CTRL_UP    600
+#define CELS_KEY_CTRL_DOWN  601
+#define CELS_KEY_CTRL_RIGHT 602
+#define CELS_KEY_CTRL_LEFT  603
+
+/* Custom key codes for Shift+Arrow (text selection support) */
+#define CELS_KEY_SHIFT_LEFT  604
+#define CELS_KEY_SHIFT_RIGHT 605
+
+/* Internal key codes, never reported as keys */
+#define CELS_KEY_PASTE_BEGIN 606    /* Bracketed paste markers */
+#define CELS_KEY_PASTE_END   607
+#define CELS_KEY_SGR_MOUSE   608    /* SGR mouse prefix; parameters follow */
+
+/* Raw input parser -- defined in input/tui_input_parser.c */
+typedef enum TUI_InputTokenType {
+    TUI_TOKEN_KEY = 1,          /* code (ncurses key code), mods */
+    TUI_TOKEN_MOUSE,            /* code = button byte, x/y 0-based, release */
+    TUI_TOKEN_PASTE_BEGIN,
+    TUI_TOKEN_PASTE_BYTE,       /* code = raw byte inside a paste */
+    TUI_TOKEN_PASTE_END,
+    TUI_TOKEN_KITTY_FLAGS       /* code = kitty keyboard flags (query reply) */
+} TUI_InputTokenType;
+
+typedef struct TUI_InputToken {
+    TUI_InputTokenType type;
+    int code;
+    int mods;                   /* NCURSES_MOD_* */
+    int x, y;
+    bool release;
+} TUI_InputToken;
+
+typedef void (*TUI_InputTokenFn)(const TUI_InputToken* tok, void* user);
+
+extern void tui_input_parser_reset(void);
+extern void tui_input_parser_feed(const unsigned char* bytes, size_t len,
+                                  TUI_InputTokenFn fn, void* user);
+extern void tui_input_parser_set_kitty(bool confirmed);
+extern int64_t tui_input_parser_idle(uint64_t now_ns, TUI_InputTokenFn fn, void* user);
+
+/* Input reader thread -- defined in input/tui_input_thread.c */
+typedef struct TUI_InputQueued {
+    TUI_InputToken tok;
+    uint64_t time_ns;           /* CLOCK_MONOTONIC arrival time */
+} TUI_InputQueued;
+
+extern bool ncurses_input_thread_start(int input_fd);
+extern void ncurses_input_thread_stop(void);
+extern bool ncurses_input_thread_active(void);
+extern bool ncurses_input_thread_lost(void);
+extern bool ncurses_input_thread_pop(TUI_InputQueued* out);
+extern bool ncurses_input_thread_wait(long timeout_us, int extra_fd, bool* extra_ready);
 
 /* Surface panel operations -- defined in layer/tui_surface_panel.c */
 extern TUI_DrawContext_Component ncurses_surface_panel_create(
     const TUI_SurfaceConfig* config, cels_entity_t entity);
 extern void ncurses_surface_panel_destroy(const TUI_DrawContext_Component* dc);
 extern void ncurses_surface_panel_resize(TUI_DrawContext_Component* dc, int new_w, int new_h);
-extern void ncurses_surface_sync_visibility(bool visible, PANEL* panel);
+extern bool ncurses_surface_geometry_changed(const TUI_SurfaceConfig* config,
+                                             const TUI_DrawContext_Component* dc);
+extern void ncurses_surface_apply_geometry(TUI_DrawContext_Component* dc,
+                                           const TUI_SurfaceConfig* config);
+extern bool ncurses_surface_virtual_changed(const TUI_SurfaceConfig* config,
+                                            const TUI_DrawContext_Component* dc);
+extern void ncurses_surface_apply_virtual(TUI_DrawContext_Component* dc,
+                                          const TUI_SurfaceConfig* config);
+extern void ncurses_surface_sync_visibility(bool visible, TUI_SurfaceSlot* slot);
+extern void ncurses_surface_set_z_order(TUI_SurfaceSlot* slot, int z_order);
 extern void ncurses_surface_clear_window(WINDOW* win, TUI_SubCellBuffer* subcell_buf);
-extern void ncurses_surface_sort_and_stack(PANEL** panels, int* z_orders, int count);
+extern void ncurses_surface_commit(TUI_DrawContext_Component* dc);
+extern void ncurses_surface_restack(void);
+extern void ncurses_surface_pool_drain(void);
+extern void ncurses_surface_pool_open(void);
+extern void ncurses_surface_set_opaque(TUI_SurfaceSlot* slot, bool opaque);
+extern void ncurses_surface_update_occlusion(void);
+extern void ncurses_surface_apply_occlusion(TUI_DrawContext_Component* dc, bool persistent);
+
+/* Pipelined terminal output -- defined in window/tui_output.c */
+extern FILE* ncurses_output_pipeline_start(int term_fd);
+extern void ncurses_output_pipeline_attach_tty(void);
+extern bool ncurses_output_pipeline_busy(void);
+extern int ncurses_output_pipeline_fd(void);
+extern void ncurses_output_pipeline_stop(void);
+
+/* Input-to-flush latency tracer -- defined in window/tui_latency.c */
+extern void ncurses_latency_init(void);
+extern void ncurses_latency_input(uint64_t oldest_ns, uint64_t newest_ns);
+extern void ncurses_latency_frame_end(bool flushed);
+extern void ncurses_latency_dump(void);
 
 /* Terminal spawn: kill child terminal emulator on shutdown */
 extern void ncurses_kill_terminal(void);
 
+/* Terminal spawn, PTY mode: relay resize notifications */
+extern int ncurses_terminal_control_fd(void);
+extern bool ncurses_terminal_control_resized(void);
+
+/* Headless session -- defined in window/tui_session.c */
+extern int ncurses_session_start(const char* sock_path, int* control_fd);
+extern void ncurses_session_stop(void);
+extern bool ncurses_session_detached(void);
+extern bool ncurses_session_take_attach(void);
+
 #endif /* CELS_NCURSES_TUI_INTERNAL_H */
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * TUI Latency Tracer - Input arrival to terminal flush
+ *
+ * Owns the canonical NCurses_LatencyState (this TU's CEL_State static).
+ *
+ * NCurses_InputSystem reports the arrival span (oldest, newest) of the
+ * events each frame consumed via ncurses_latency_input(). After
+ * TUI_FrameEndSystem's doupdate(), ncurses_latency_frame_end() stamps the
+ * flush and records the latency of the frame's oldest input. A frame whose
+ * doupdate() was skipped (pipelined output still busy) carries its span to
+ * the next frame that flushes, since that is when its input becomes visible.
+ *
+ * The stamp is taken when doupdate() returns: with direct output the bytes
+ * have been written to the terminal fd; with pipelined output they are in
+ * the pipe and the writer thread sends them shortly after.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include "../tui_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <cels/cels.h>
+
+/* CEL_State(NCurses_LatencyState) — owned by this TU */
+static struct NCurses_LatencyState NCurses_LatencyState = { 0 };
+
+/* Input consumed but not yet flushed (0 = none) */
+static uint64_t g_pending_oldest = 0;
+static uint64_t g_pending_newest = 0;
+
+static const char* g_dump_path = NULL;
+
+/* ============================================================================
+ * Histogram
+ * ============================================================================ */
+
+static int latency_bucket(uint64_t ns) {
+    uint64_t limit_us = NCURSES_LATENCY_BUCKET0_US;
+    for (int i = 0; i < NCURSES_LATENCY_BUCKETS - 1; i++) {
+        if (ns < limit_us * 1000) return i;
+        limit_us <<= 1;
+    }
+    return NCURSES_LATENCY_BUCKETS - 1;
+}
+
+/* Upper bound of the bucket holding the given fraction of samples (the
+ * open-ended last bucket reports the maximum instead) */
+static uint64_t latency_percentile_us(double fraction) {
+    uint64_t want = (uint64_t)((double)NCurses_LatencyState.frames * fraction + 0.5);
+    if (want == 0) want = 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < NCURSES_LATENCY_BUCKETS - 1; i++) {
+        seen += NCurses_LatencyState.histogram[i];
+        if (seen >= want) return (uint64_t)NCURSES_LATENCY_BUCKET0_US << i;
+    }
+    return NCurses_LatencyState.max_ns / 1000;
+}
+
+/* ============================================================================
+ * Frame Hooks
+ * ============================================================================ */
+
+void ncurses_latency_input(uint64_t oldest_ns, uint64_t newest_ns) {
+    if (!oldest_ns) return;
+    if (!g_pending_oldest || oldest_ns < g_pending_oldest) g_pending_oldest = oldest_ns;
+    if (newest_ns > g_pending_newest) g_pending_newest = newest_ns;
+}
+
+void ncurses_latency_frame_end(bool flushed) {
+    if (!flushed || !g_pending_oldest) return;
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t now = (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+    uint64_t oldest = now > g_pending_oldest ? now - g_pending_oldest : 0;
+    uint64_t newest = now > g_pending_newest ? now - g_pending_newest : 0;
+    g_pending_oldest = 0;
+    g_pending_newest = 0;
+
+    cel_mutate(NCurses_LatencyState) {
+        NCurses_LatencyState.frames++;
+        NCurses_LatencyState.last_oldest_ns = oldest;
+        NCurses_LatencyState.last_newest_ns = newest;
+        if (oldest > NCurses_LatencyState.max_ns) NCurses_LatencyState.max_ns = oldest;
+        NCurses_LatencyState.histogram[latency_bucket(oldest)]++;
+        NCurses_LatencyState.p50_us = latency_percentile_us(0.50);
+        NCurses_LatencyState.p90_us = latency_percentile_us(0.90);
+        NCurses_LatencyState.p99_us = latency_percentile_us(0.99);
+    }
+}
+
+/* ============================================================================
+ * Lifecycle
+ * ============================================================================ */
+
+void ncurses_latency_init(void) {
+    NCurses_LatencyState_register();
+    memset(&NCurses_LatencyState, 0, sizeof(NCurses_LatencyState));
+    cels_state_bind(NCurses_LatencyState);
+    g_pending_oldest = 0;
+    g_pending_newest = 0;
+
+    const char* path = getenv("CELS_NCURSES_LATENCY_DUMP");
+    g_dump_path = (path && path[0]) ? path : NULL;
+}
+
+/* Write the histogram to CELS_NCURSES_LATENCY_DUMP, once */
+void ncurses_latency_dump(void) {
+    if (!g_dump_path) return;
+    FILE* f = fopen(g_dump_path, "w");
+    g_dump_path = NULL;
+    if (!f) return;
+
+    const struct NCurses_LatencyState* s = &NCurses_LatencyState;
+    fprintf(f, "# cels-ncurses input-to-flush latency (oldest input per frame)\n");
+    fprintf(f, "frames %llu\n", (unsigned long long)s->frames);
+    fprintf(f, "max_us %llu\n", (unsigned long long)(s->max_ns / 1000));
+    fprintf(f, "p50_us %llu\n", (unsigned long long)s->p50_us);
+    fprintf(f, "p90_us %llu\n", (unsigned long long)s->p90_us);
+    fprintf(f, "p99_us %llu\n", (unsigned long long)s->p99_us);
+    fprintf(f, "# below_us count\n");
+    for (int i = 0; i < NCURSES_LATENCY_BUCKETS; i++) {
+        if (i == NCURSES_LATENCY_BUCKETS - 1) {
+            fprintf(f, "inf %u\n", s->histogram[i]);
+        } else {
+            fprintf(f, "%llu %u\n",
+                    (unsigned long long)NCURSES_LATENCY_BUCKET0_US << i, s->histogram[i]);
+        }
+    }
+    fclose(f);
+}
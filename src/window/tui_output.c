@@ -0,0 +1,241 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * TUI Output Pipeline - Terminal writes on a dedicated thread
+ *
+ * With NCursesWindow(.pipelined = true) ncurses is given the write end of a
+ * pipe instead of the terminal. doupdate() still diffs and encodes the frame
+ * on the main thread, but its bytes land in the pipe buffer and return
+ * immediately; a writer thread relays them to the real terminal fd while
+ * the main thread moves on to the next frame's OnLoad/OnUpdate systems.
+ *
+ * The pipe holds at most one frame in flight: TUI_FrameEndSystem asks
+ * ncurses_output_pipeline_busy() before compositing and, while the writer
+ * is still draining the previous frame, skips update_panels()/doupdate()
+ * for this frame. Nothing is lost -- ncurses keeps the pending changes and
+ * the next doupdate() emits them together.
+ *
+ * Because ncurses' output fd is a pipe, its tty calls (terminal modes,
+ * size query) no longer reach the terminal. attach_tty() applies the same
+ * modes newterm()+cbreak() would set and sizes the screen from the real
+ * fd; stop() restores the saved modes after the last bytes are written.
+ *
+ * The writer blocks in poll() on the pipe and a stop pipe with no timeout,
+ * so an idle app makes no syscalls; stop() writes the stop byte and the
+ * writer exits once the output pipe is empty.
+ */
+
+#include "../tui_internal.h"
+#include <ncurses.h>
+#include <pthread.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+#define OUTPUT_CHUNK_SIZE   (64 * 1024)
+#define OUTPUT_PIPE_SIZE    (1024 * 1024)
+#define OUTPUT_POLL_MS      50              /* Terminal full: retry interval */
+
+static bool g_out_active = false;
+static int g_term_fd = -1;          /* Real terminal fd (borrowed, not closed) */
+static int g_pipe_r = -1;
+static FILE* g_out_file = NULL;     /* Write end, handed to newterm() */
+static pthread_t g_writer;
+static int g_writing = 0;           /* Writer is mid-write (atomic) */
+static int g_stop_pipe[2] = { -1, -1 };    /* Main -> writer: exit once drained */
+
+static struct termios g_saved_tio;
+static bool g_tio_saved = false;
+
+/* ============================================================================
+ * Writer Thread
+ * ============================================================================ */
+
+static void write_all(int fd, const char* buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN) {
+                struct pollfd pfd = { .fd = fd, .events = POLLOUT };
+                poll(&pfd, 1, OUTPUT_POLL_MS);
+                continue;
+            }
+            return;  /* Terminal gone -- drop the rest */
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+}
+
+static void* output_writer(void* arg) {
+    (void)arg;
+
+    /* Signals belong to the main thread (SIGWINCH is blocked there while
+     * rendering and must not be delivered here instead) */
+    sigset_t all;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, NULL);
+
+    char* buf = malloc(OUTPUT_CHUNK_SIZE);
+    if (!buf) return NULL;
+
+    for (;;) {
+        struct pollfd pfd[2] = {
+            { .fd = g_pipe_r, .events = POLLIN },
+            { .fd = g_stop_pipe[0], .events = POLLIN },
+        };
+        int pr = poll(pfd, 2, -1);
+        if (pr < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (!(pfd[0].revents & (POLLIN | POLLHUP | POLLERR))) {
+            if (pfd[1].revents) break;  /* Stop requested and the pipe is empty */
+            continue;
+        }
+
+        /* Raise the flag before the bytes leave the pipe, so
+         * ncurses_output_pipeline_busy() sees them in one place or the other */
+        __atomic_store_n(&g_writing, 1, __ATOMIC_SEQ_CST);
+        ssize_t n = read(g_pipe_r, buf, OUTPUT_CHUNK_SIZE);
+        if (n > 0) write_all(g_term_fd, buf, (size_t)n);
+        __atomic_store_n(&g_writing, 0, __ATOMIC_RELEASE);
+        if (n < 0 && (errno == EINTR || errno == EAGAIN)) continue;
+        if (n <= 0) break;
+    }
+
+    free(buf);
+    return NULL;
+}
+
+/* ============================================================================
+ * Pipeline Lifecycle
+ * ============================================================================ */
+
+static void close_stop_pipe(void) {
+    close(g_stop_pipe[0]);
+    close(g_stop_pipe[1]);
+    g_stop_pipe[0] = g_stop_pipe[1] = -1;
+}
+
+FILE* ncurses_output_pipeline_start(int term_fd) {
+    if (g_out_active || term_fd < 0) return NULL;
+
+    int fds[2];
+    if (pipe(g_stop_pipe) != 0) return NULL;
+    fcntl(g_stop_pipe[0], F_SETFD, FD_CLOEXEC);
+    fcntl(g_stop_pipe[1], F_SETFD, FD_CLOEXEC);
+    if (pipe(fds) != 0) {
+        close_stop_pipe();
+        return NULL;
+    }
+#ifdef F_SETPIPE_SZ
+    fcntl(fds[1], F_SETPIPE_SZ, OUTPUT_PIPE_SIZE);
+#endif
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+
+    FILE* out = fdopen(fds[1], "w");
+    if (!out) {
+        close(fds[0]);
+        close(fds[1]);
+        close_stop_pipe();
+        return NULL;
+    }
+    setvbuf(out, NULL, _IONBF, 0);
+
+    g_term_fd = term_fd;
+    g_pipe_r = fds[0];
+    g_out_file = out;
+    g_writing = 0;
+    if (pthread_create(&g_writer, NULL, output_writer, NULL) != 0) {
+        fclose(out);
+        close(fds[0]);
+        close_stop_pipe();
+        g_term_fd = -1;
+        g_pipe_r = -1;
+        g_out_file = NULL;
+        return NULL;
+    }
+
+    g_out_active = true;
+    return out;
+}
+
+void ncurses_output_pipeline_attach_tty(void) {
+    if (!g_out_active) return;
+
+    if (tcgetattr(g_term_fd, &g_saved_tio) == 0) {
+        g_tio_saved = true;
+        struct termios tio = g_saved_tio;
+        tio.c_lflag &= (tcflag_t)~(ICANON | ECHO | ECHONL);
+        tio.c_lflag |= ISIG;
+        tio.c_iflag &= (tcflag_t)~(ICRNL | INLCR | IGNCR);
+        tio.c_oflag &= (tcflag_t)~ONLCR;
+        tio.c_cc[VMIN] = 1;
+        tio.c_cc[VTIME] = 0;
+        tcsetattr(g_term_fd, TCSANOW, &tio);
+    }
+
+    struct winsize ws;
+    if (ioctl(g_term_fd, TIOCGWINSZ, &ws) == 0 && ws.ws_row > 0 && ws.ws_col > 0) {
+        resizeterm(ws.ws_row, ws.ws_col);
+    }
+}
+
+/* Pipe first, flag second: the writer raises the flag before it reads, so
+ * bytes that were gone from the pipe are still counted as mid-write */
+bool ncurses_output_pipeline_busy(void) {
+    if (!g_out_active) return false;
+    int pending = 0;
+    if (ioctl(g_pipe_r, FIONREAD, &pending) == 0 && pending > 0) return true;
+    return __atomic_load_n(&g_writing, __ATOMIC_SEQ_CST) != 0;
+}
+
+int ncurses_output_pipeline_fd(void) {
+    return g_out_active ? g_term_fd : -1;
+}
+
+void ncurses_output_pipeline_stop(void) {
+    if (!g_out_active) return;
+
+    /* Drain: the writer exits once the pipe is empty */
+    char byte = 1;
+    while (write(g_stop_pipe[1], &byte, 1) < 0 && errno == EINTR) { /* retry */ }
+    pthread_join(g_writer, NULL);
+    close_stop_pipe();
+
+    /* ncurses still owns g_out_file; point its fd straight at the terminal
+     * so any later output (e.g. from delscreen) is not lost in the pipe */
+    dup2(g_term_fd, fileno(g_out_file));
+    close(g_pipe_r);
+    g_pipe_r = -1;
+
+    if (g_tio_saved) {
+        tcsetattr(g_term_fd, TCSADRAIN, &g_saved_tio);
+        g_tio_saved = false;
+    }
+    g_out_active = false;
+}
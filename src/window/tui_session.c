@@ -0,0 +1,625 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * TUI Session - Headless rendering with attachable clients
+ *
+ * With CELS_NCURSES_SESSION=<socket path> the application needs no
+ * terminal. ncurses renders into a PTY owned by this process, the same way
+ * it renders into the relay's PTY when an emulator is spawned, and a
+ * session thread serves that PTY on a Unix socket:
+ *
+ *   1. openpty() creates the pair; ncurses gets the master via newterm()
+ *   2. The session thread listens on the socket and reads the slave
+ *   3. While no client is attached, the frame loop flushes nothing and the
+ *      thread discards whatever is left on the slave: nothing is sent
+ *   4. A client attaches and reports its size. The slave is resized, the
+ *      frame loop re-sends the terminal modes and repaints the whole
+ *      screen (the snapshot), and every later frame is ncurses' usual diff
+ *   5. The client's input is written to the slave, where ncurses reads it
+ *
+ * Resizes reach the frame loop as the relay's control messages do (see
+ * ncurses_terminal_control_fd in tui_spawn.c), so the PTY-mode resize and
+ * frame-wait paths in tui_window.c serve both.
+ *
+ * Any cels-ncurses binary is also the attach client: started with
+ * CELS_NCURSES_ATTACH=<socket path>, a constructor connects, puts the
+ * terminal in raw mode and bridges it until Ctrl+\ detaches or the
+ * session ends.
+ *
+ * Client -> server messages: type byte, 16-bit big-endian length, payload.
+ *   'S'  size: rows, cols (16-bit big-endian each)
+ *   'I'  input bytes
+ * Server -> client: the raw terminal output stream.
+ */
+
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE
+#endif
+
+#include "../tui_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <termios.h>
+#include <errno.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#if defined(__linux__)
+#include <pty.h>
+#elif defined(__APPLE__)
+#include <util.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0          /* macOS: SO_NOSIGPIPE is set per socket */
+#endif
+
+#define SESSION_CHUNK_SIZE   (64 * 1024)
+#define SESSION_INPUT_MAX    4096           /* Largest 'I' payload */
+#define SESSION_INPUT_QUEUE  (64 * 1024)    /* Client input waiting for the slave */
+#define SESSION_SEND_TIMEOUT 2              /* Seconds before a stuck client is dropped */
+#define SESSION_DEFAULT_COLS 80
+#define SESSION_DEFAULT_ROWS 24
+
+#define SESSION_MSG_SIZE     'S'
+#define SESSION_MSG_INPUT    'I'
+#define SESSION_MSG_RESIZE   'W'            /* To the frame loop; RELAY_MSG_RESIZE in tui_spawn.c */
+
+#define SESSION_DETACH_KEY   0x1c           /* Ctrl+\ */
+#define SESSION_DETACH_KITTY "\033[92;5u"   /* Ctrl+\ under the kitty keyboard protocol */
+
+/* ============================================================================
+ * Session State
+ * ============================================================================ */
+
+static bool g_session_active = false;
+static pthread_t g_session_thread;
+static char g_sock_path[sizeof(((struct sockaddr_un*)0)->sun_path)];
+static int g_listen_fd = -1;
+static int g_slave_fd = -1;
+static int g_ctrl_fd = -1;                  /* Thread's end; the frame loop holds the other */
+static int g_wake[2] = { -1, -1 };          /* Stop request */
+
+/* Session thread only */
+static int g_client_fd = -1;
+static unsigned char g_frame[3 + SESSION_INPUT_MAX];
+static size_t g_frame_len = 0;
+
+/* Client input not yet written to the slave. Writes never block: while
+ * ncurses is busy writing output to the PTY, the thread must keep reading
+ * that output or both sides would wait on each other. */
+static unsigned char g_input[SESSION_INPUT_QUEUE];
+static size_t g_input_len = 0;
+
+static int g_attached = 0;                  /* A client reported its size (atomic) */
+static int g_attach_pending = 0;            /* Frame loop has not repainted for it yet (atomic) */
+
+static void set_cloexec(int fd) {
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+}
+
+static void set_nonblock(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+static void set_nosigpipe(int fd) {
+#if defined(SO_NOSIGPIPE)
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#else
+    (void)fd;
+#endif
+}
+
+/* Write everything, waiting while fd is full. False if fd failed. */
+static bool session_write_all(int fd, const void* data, size_t len, bool sock) {
+    const char* p = data;
+    while (len > 0) {
+        ssize_t n = sock ? send(fd, p, len, MSG_NOSIGNAL) : write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                if (sock) return false;     /* SO_SNDTIMEO expired: client stuck */
+                struct pollfd pfd = { .fd = fd, .events = POLLOUT };
+                poll(&pfd, 1, -1);
+                continue;
+            }
+            return false;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+/* ============================================================================
+ * Session Thread
+ * ============================================================================ */
+
+static void session_drop_client(void) {
+    if (g_client_fd < 0) return;
+    close(g_client_fd);
+    g_client_fd = -1;
+    g_frame_len = 0;
+    __atomic_store_n(&g_attached, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&g_attach_pending, 0, __ATOMIC_RELEASE);
+}
+
+/* A newer client takes over from the current one */
+static void session_accept(void) {
+    int fd = accept(g_listen_fd, NULL, NULL);
+    if (fd < 0) return;
+    set_cloexec(fd);
+    set_nosigpipe(fd);
+    struct timeval tv = { .tv_sec = SESSION_SEND_TIMEOUT };
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    session_drop_client();
+    g_client_fd = fd;
+}
+
+static void session_resize(int rows, int cols) {
+    if (rows <= 0 || cols <= 0) return;
+    struct winsize ws = { .ws_row = (unsigned short)rows, .ws_col = (unsigned short)cols };
+    ioctl(g_slave_fd, TIOCSWINSZ, &ws);
+
+    /* First size: the client is attached and needs a full frame */
+    if (!__atomic_load_n(&g_attached, __ATOMIC_ACQUIRE)) {
+        __atomic_store_n(&g_attach_pending, 1, __ATOMIC_RELEASE);
+        __atomic_store_n(&g_attached, 1, __ATOMIC_RELEASE);
+    }
+    char msg = SESSION_MSG_RESIZE;
+    send(g_ctrl_fd, &msg, 1, MSG_NOSIGNAL | MSG_DONTWAIT);
+}
+
+/* Handle every complete message that fits. Stops early when the input
+ * queue has no room; the rest waits in g_frame until it drains. */
+static void session_parse_frames(void) {
+    size_t off = 0;
+    while (g_frame_len - off >= 3) {
+        const unsigned char* m = g_frame + off;
+        size_t len = ((size_t)m[1] << 8) | m[2];
+        if (len > SESSION_INPUT_MAX) {
+            session_drop_client();          /* Not our protocol */
+            return;
+        }
+        if (g_frame_len - off < 3 + len) break;
+
+        if (m[0] == SESSION_MSG_SIZE && len == 4) {
+            session_resize((m[3] << 8) | m[4], (m[5] << 8) | m[6]);
+        } else if (m[0] == SESSION_MSG_INPUT
+                   && __atomic_load_n(&g_attached, __ATOMIC_ACQUIRE)) {
+            if (sizeof(g_input) - g_input_len < len) break;
+            memcpy(g_input + g_input_len, m + 3, len);
+            g_input_len += len;
+        }
+        off += 3 + len;
+    }
+    memmove(g_frame, g_frame + off, g_frame_len - off);
+    g_frame_len -= off;
+}
+
+/* Read from the client, if there is room for it */
+static void session_client_read(void) {
+    if (g_frame_len == sizeof(g_frame)) return;
+    ssize_t n = recv(g_client_fd, g_frame + g_frame_len,
+                     sizeof(g_frame) - g_frame_len, 0);
+    if (n < 0 && (errno == EINTR || errno == EAGAIN)) return;
+    if (n <= 0) {
+        session_drop_client();
+        return;
+    }
+    g_frame_len += (size_t)n;
+    session_parse_frames();
+}
+
+/* Write as much queued input to the slave as it takes now */
+static void session_flush_input(void) {
+    size_t done = 0;
+    while (done < g_input_len) {
+        ssize_t n = write(g_slave_fd, g_input + done, g_input_len - done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;                  /* EAGAIN: wait for POLLOUT */
+        done += (size_t)n;
+    }
+    memmove(g_input, g_input + done, g_input_len - done);
+    g_input_len -= done;
+}
+
+static void* session_main(void* arg) {
+    (void)arg;
+
+    /* Signals belong to the main thread */
+    sigset_t all;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, NULL);
+
+    char* buf = malloc(SESSION_CHUNK_SIZE);
+    if (!buf) return NULL;
+
+    for (;;) {
+        /* Client messages are read only while there is room for them;
+         * the slave is watched for POLLOUT only while input is queued */
+        int client = g_client_fd;
+        struct pollfd pfd[4] = {
+            { .fd = g_wake[0], .events = POLLIN },
+            { .fd = g_listen_fd, .events = POLLIN },
+            { .fd = g_slave_fd, .events = POLLIN | (g_input_len ? POLLOUT : 0) },
+            { .fd = client,                         /* Ignored when -1 */
+              .events = g_frame_len < sizeof(g_frame) ? POLLIN : 0 },
+        };
+        if (poll(pfd, 4, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (pfd[0].revents) break;
+
+        /* Terminal output: to the client, or nowhere while detached */
+        if (pfd[2].revents & POLLIN) {
+            ssize_t n = read(g_slave_fd, buf, SESSION_CHUNK_SIZE);
+            if (n > 0 && __atomic_load_n(&g_attached, __ATOMIC_ACQUIRE)
+                && !session_write_all(g_client_fd, buf, (size_t)n, true)) {
+                session_drop_client();
+            }
+        }
+
+        /* Input: drain the queue, then take messages that were held back */
+        if (pfd[2].revents & POLLOUT) {
+            session_flush_input();
+            if (g_client_fd >= 0) session_parse_frames();
+        }
+
+        if (client >= 0 && client == g_client_fd
+            && (pfd[3].revents & (POLLIN | POLLHUP | POLLERR))) {
+            session_client_read();
+            session_flush_input();
+        }
+
+        if (pfd[1].revents & POLLIN) session_accept();
+    }
+
+    free(buf);
+    return NULL;
+}
+
+/* ============================================================================
+ * Server
+ * ============================================================================ */
+
+/* Listen on path (mode 0600). A stale socket left by a crashed session is
+ * replaced; one with a live server behind it is not. */
+static int session_listen(const char* path) {
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "[NCurses] Session socket path too long: %s\n", path);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+
+    struct stat st;
+    if (lstat(path, &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            fprintf(stderr, "[NCurses] %s exists and is not a socket\n", path);
+            return -1;
+        }
+        int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        bool live = probe >= 0
+                 && connect(probe, (struct sockaddr*)&addr, sizeof(addr)) == 0;
+        if (probe >= 0) close(probe);
+        if (live) {
+            fprintf(stderr, "[NCurses] A session is already running on %s\n", path);
+            return -1;
+        }
+        unlink(path);
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    set_cloexec(fd);
+    /* Nobody can connect before listen(), so restricting the mode in
+     * between leaves no window */
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0
+        || chmod(path, 0600) != 0 || listen(fd, 4) != 0) {
+        fprintf(stderr, "[NCurses] Cannot listen on %s: %s\n", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void session_close_fds(void) {
+    int* fds[] = { &g_listen_fd, &g_slave_fd, &g_ctrl_fd, &g_wake[0], &g_wake[1] };
+    for (size_t i = 0; i < sizeof(fds) / sizeof(fds[0]); i++) {
+        if (*fds[i] >= 0) close(*fds[i]);
+        *fds[i] = -1;
+    }
+}
+
+/* Undo a partial ncurses_session_start() */
+static int session_abort(int master_fd, int ctrl_fd) {
+    if (master_fd >= 0) close(master_fd);
+    if (ctrl_fd >= 0) close(ctrl_fd);
+    session_close_fds();
+    unlink(g_sock_path);
+    return -1;
+}
+
+/* Start serving a headless session on sock_path. Returns the PTY master
+ * for newterm() and *control_fd, the frame loop's end of the resize
+ * channel; -1 on failure. */
+int ncurses_session_start(const char* sock_path, int* control_fd) {
+    *control_fd = -1;
+    if (g_session_active) return -1;
+
+    g_listen_fd = session_listen(sock_path);
+    if (g_listen_fd < 0) return -1;
+    strcpy(g_sock_path, sock_path);
+
+    struct winsize ws = { .ws_row = SESSION_DEFAULT_ROWS, .ws_col = SESSION_DEFAULT_COLS };
+    int master_fd = -1;
+    if (openpty(&master_fd, &g_slave_fd, NULL, NULL, &ws) != 0) {
+        fprintf(stderr, "[NCurses] Cannot open session PTY: %s\n", strerror(errno));
+        return session_abort(-1, -1);
+    }
+
+    /* Raw until ncurses sets its own modes on the master */
+    struct termios raw;
+    if (tcgetattr(g_slave_fd, &raw) == 0) {
+        cfmakeraw(&raw);
+        tcsetattr(g_slave_fd, TCSANOW, &raw);
+    }
+    int ctrl[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, ctrl) != 0) return session_abort(master_fd, -1);
+    g_ctrl_fd = ctrl[0];
+    if (pipe(g_wake) != 0) return session_abort(master_fd, ctrl[1]);
+
+    int fds[] = { master_fd, g_slave_fd, ctrl[0], ctrl[1], g_wake[0], g_wake[1] };
+    for (size_t i = 0; i < sizeof(fds) / sizeof(fds[0]); i++) set_cloexec(fds[i]);
+    set_nonblock(g_slave_fd);
+    set_nosigpipe(g_ctrl_fd);
+
+    g_client_fd = -1;
+    g_frame_len = 0;
+    g_input_len = 0;
+    __atomic_store_n(&g_attached, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&g_attach_pending, 0, __ATOMIC_RELEASE);
+    if (pthread_create(&g_session_thread, NULL, session_main, NULL) != 0) {
+        fprintf(stderr, "[NCurses] Cannot start session thread\n");
+        return session_abort(master_fd, ctrl[1]);
+    }
+    g_session_active = true;
+    *control_fd = ctrl[1];
+    fprintf(stderr, "[NCurses] Headless session on %s\n", sock_path);
+    return master_fd;
+}
+
+/* Disconnect the client and stop serving. The socket file is removed. */
+void ncurses_session_stop(void) {
+    if (!g_session_active) return;
+    char b = 0;
+    ssize_t w = write(g_wake[1], &b, 1);
+    (void)w;
+    pthread_join(g_session_thread, NULL);
+    session_drop_client();
+    session_close_fds();
+    unlink(g_sock_path);
+    g_session_active = false;
+}
+
+/* True while output should be held: no client, or one that has not been
+ * sent its first full frame yet (see ncurses_session_take_attach) */
+bool ncurses_session_detached(void) {
+    if (!g_session_active) return false;
+    return !__atomic_load_n(&g_attached, __ATOMIC_ACQUIRE)
+        || __atomic_load_n(&g_attach_pending, __ATOMIC_ACQUIRE);
+}
+
+/* True once per attach: the frame loop must re-send terminal modes and
+ * repaint everything for the new client */
+bool ncurses_session_take_attach(void) {
+    if (!g_session_active) return false;
+    return __atomic_exchange_n(&g_attach_pending, 0, __ATOMIC_ACQ_REL) != 0;
+}
+
+/* ============================================================================
+ * Attach Client (CELS_NCURSES_ATTACH)
+ * ============================================================================
+ *
+ * Runs in a constructor, before main(), and exits. The terminal is put in
+ * raw mode and the alternate screen; everything the session sends is
+ * written to it, and keys are forwarded until Ctrl+\ detaches.
+ */
+
+/* Undo every mode a session may have set on this terminal */
+#define ATTACH_RESTORE "\033[<u\033[?2004l\033[?1006l\033[?1003l\033[?1000l" \
+                       "\033[?1l\033>\033[?25h\033[0m\033[?1049l"
+
+static int g_attach_winch[2] = { -1, -1 };
+
+static void attach_sigwinch_handler(int sig) {
+    (void)sig;
+    char b = 0;
+    ssize_t w = write(g_attach_winch[1], &b, 1);
+    (void)w;
+}
+
+/* Keys waiting for the socket. The client never blocks on a send: it has
+ * to keep draining session output, or a paste and a busy app stall each
+ * other until the server drops the connection. */
+static unsigned char g_attach_out[SESSION_INPUT_QUEUE];
+static size_t g_attach_out_len = 0;
+
+static void attach_queue(char type, const void* data, size_t len) {
+    if (g_attach_out_len + 3 + len > sizeof(g_attach_out)) return;
+    unsigned char* p = g_attach_out + g_attach_out_len;
+    p[0] = (unsigned char)type;
+    p[1] = (unsigned char)(len >> 8);
+    p[2] = (unsigned char)(len & 0xff);
+    if (len > 0) memcpy(p + 3, data, len);
+    g_attach_out_len += 3 + len;
+}
+
+/* Room for one more read of stdin plus a size message */
+static bool attach_queue_has_room(void) {
+    return g_attach_out_len + (3 + SESSION_INPUT_MAX) + (3 + 4) <= sizeof(g_attach_out);
+}
+
+/* Send what the socket takes now; false once the session is gone */
+static bool attach_flush(int sock) {
+    size_t off = 0;
+    while (off < g_attach_out_len) {
+        ssize_t n = send(sock, g_attach_out + off, g_attach_out_len - off,
+                         MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n > 0) { off += (size_t)n; continue; }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        return false;
+    }
+    memmove(g_attach_out, g_attach_out + off, g_attach_out_len - off);
+    g_attach_out_len -= off;
+    return true;
+}
+
+static void attach_queue_size(void) {
+    struct winsize ws;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) != 0) return;
+    unsigned char p[4] = { ws.ws_row >> 8, ws.ws_row & 0xff,
+                           ws.ws_col >> 8, ws.ws_col & 0xff };
+    attach_queue(SESSION_MSG_SIZE, p, sizeof(p));
+}
+
+/* Queue keys; false once the user detached */
+static bool attach_forward_input(const char* buf, size_t n) {
+    size_t kitty_len = strlen(SESSION_DETACH_KITTY);
+    size_t len = 0;
+    while (len < n && buf[len] != SESSION_DETACH_KEY
+           && !(n - len >= kitty_len && memcmp(buf + len, SESSION_DETACH_KITTY, kitty_len) == 0))
+        len++;
+    if (len > 0) attach_queue(SESSION_MSG_INPUT, buf, len);
+    return len == n;
+}
+
+static int run_attach_client(const char* path) {
+    if (!isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO)) {
+        fprintf(stderr, "[attach] Needs a terminal\n");
+        return 1;
+    }
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "[attach] Socket path too long: %s\n", path);
+        return 1;
+    }
+    strcpy(addr.sun_path, path);
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock < 0 || connect(sock, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        fprintf(stderr, "[attach] Cannot connect to %s: %s\n", path, strerror(errno));
+        return 1;
+    }
+    set_nosigpipe(sock);
+    signal(SIGPIPE, SIG_IGN);
+
+    if (pipe(g_attach_winch) != 0) return 1;
+    set_nonblock(g_attach_winch[0]);
+    set_nonblock(g_attach_winch[1]);
+    struct sigaction sa = { .sa_handler = attach_sigwinch_handler };
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+    sigaction(SIGWINCH, &sa, NULL);
+
+    struct termios saved, raw;
+    tcgetattr(STDIN_FILENO, &saved);
+    raw = saved;
+    cfmakeraw(&raw);
+    tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+    const char enter[] = "\033[?1049h\033[H\033[2J";
+    session_write_all(STDOUT_FILENO, enter, sizeof(enter) - 1, false);
+
+    bool detached = false;
+    char* buf = malloc(SESSION_CHUNK_SIZE);
+    g_attach_out_len = 0;
+    attach_queue_size();
+    while (buf) {
+        struct pollfd pfd[3] = {
+            { .fd = STDIN_FILENO, .events = attach_queue_has_room() ? POLLIN : 0 },
+            { .fd = sock, .events = POLLIN | (g_attach_out_len ? POLLOUT : 0) },
+            { .fd = g_attach_winch[0], .events = POLLIN },
+        };
+        if (poll(pfd, 3, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (pfd[1].revents & (POLLIN | POLLHUP | POLLERR)) {
+            ssize_t n = recv(sock, buf, SESSION_CHUNK_SIZE, MSG_DONTWAIT);
+            if (n < 0 && (errno == EINTR || errno == EAGAIN)) continue;
+            if (n <= 0) break;      /* Session ended */
+            session_write_all(STDOUT_FILENO, buf, (size_t)n, false);
+        }
+        if (pfd[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+            ssize_t n = read(STDIN_FILENO, buf, SESSION_INPUT_MAX);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;      /* Terminal gone */
+            if (!attach_forward_input(buf, (size_t)n)) {
+                detached = true;
+                break;
+            }
+        }
+        if (pfd[2].revents & POLLIN) {
+            char drain[64];
+            while (read(g_attach_winch[0], drain, sizeof(drain)) > 0) {}
+            attach_queue_size();
+        }
+        if (g_attach_out_len > 0 && !attach_flush(sock)) break;
+    }
+    if (detached) attach_flush(sock);   /* Keys typed before the detach key */
+    free(buf);
+    close(sock);
+
+    const char restore[] = ATTACH_RESTORE;
+    session_write_all(STDOUT_FILENO, restore, sizeof(restore) - 1, false);
+    tcsetattr(STDIN_FILENO, TCSANOW, &saved);
+    fprintf(stderr, detached ? "[detached from %s]\n" : "[session %s ended]\n", path);
+    return 0;
+}
+
+__attribute__((constructor))
+static void ncurses_check_attach(void) {
+    const char* path = getenv("CELS_NCURSES_ATTACH");
+    if (path && path[0]) _exit(run_attach_client(path));
+}
+
+#else
+
+int ncurses_session_start(const char* sock_path, int* control_fd) {
+    (void)sock_path;
+    *control_fd = -1;
+    return -1;
+}
+void ncurses_session_stop(void) {}
+bool ncurses_session_detached(void) { return false; }
+bool ncurses_session_take_attach(void) { return false; }
+
+#endif /* __linux__ || __APPLE__ */
@@ -26,21 +26,33 @@
  *   1. openpty() creates a master/slave PTY pair
  *   2. fork() a child that execs a terminal emulator running our own
  *      binary as a PTY relay (detected via CELS_NCURSES_PTY_RELAY env var)
- *   3. The relay process bridges the terminal's stdin/stdout to our slave PTY
- *      using select() and handles SIGWINCH for resize propagation
- *   4. Parent uses the master fd with newterm() for ncurses rendering
- *   5. ncurses_console_log() writes to stderr (goes to IDE console)
+ *   3. Direct mode: the relay sends the terminal's own tty fds to us over
+ *      a Unix socket (SCM_RIGHTS) and waits, forwarding SIGWINCH/SIGINT
+ *   4. Otherwise the relay bridges the terminal's stdin/stdout to our slave
+ *      PTY using poll() (splice() for output on Linux) and handles SIGWINCH
+ *      for resize propagation
+ *   5. Parent uses the tty (direct) or master fd with newterm() for
+ *      ncurses rendering
+ *   6. ncurses_console_log() writes to stderr (goes to IDE console)
  *
  * Controlled via CELS_NCURSES_TERMINAL env var:
  *   (unset)  = auto-detect from available terminals
  *   "kitty"  = force kitty
  *   "none"   = skip spawning, use current terminal (initscr path)
  *
+ * CELS_NCURSES_PTY_MODE=relay disables direct mode.
+ *
+ * CELS_NCURSES_SESSION=<socket> spawns nothing: the PTY is served to
+ * attach clients instead (see tui_session.c).
+ *
  * Supported terminals:
  *   Linux  - kitty, alacritty, xterm, gnome-terminal, konsole
  *   macOS  - kitty, alacritty
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE             /* splice(), F_SETPIPE_SZ */
+#endif
 #ifndef _POSIX_C_SOURCE
 #define _POSIX_C_SOURCE 200809L
 #endif
@@ -53,13 +65,18 @@
 #include <string.h>
 #include <stdbool.h>
 #include <stdarg.h>
+#include <stdint.h>
+#include <time.h>
 
 #if defined(__linux__) || defined(__APPLE__)
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/wait.h>
+#include <sys/stat.h>
 #include <sys/ioctl.h>
-#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
 #include <signal.h>
 #include <termios.h>
 #include <errno.h>
@@ -114,20 +131,66 @@ static bool get_self_exe(char* buf, size_t bufsz) {
  *
  * When our binary is re-exec'd with CELS_NCURSES_PTY_RELAY set, this
  * function runs instead of the normal application. It bridges the
- * terminal's stdin/stdout to our slave PTY using select().
+ * terminal's stdin/stdout to our slave PTY using poll().
+ *
+ * Output (ncurses rendering -> display) is the heavy direction: a
+ * full-screen truecolor redraw is tens of KB per frame. On Linux it is
+ * moved with splice() through a pipe, so the bytes never enter this
+ * process. Kernels whose tty driver cannot splice fail the first call with
+ * EINVAL, and the relay falls back to read()/write() through a buffer that
+ * grows while reads keep filling it and shrinks again when output is light.
  *
  * SIGWINCH: when the terminal emulator resizes, this relay reads the
  * new size from its own terminal (stdin) and propagates it to the
- * slave PTY via ioctl(TIOCSWINSZ). This causes a SIGWINCH on the
- * master side, which ncurses uses to update COLS/LINES.
+ * slave PTY via ioctl(TIOCSWINSZ). The application has no controlling
+ * terminal, so no SIGWINCH reaches it; the relay sends RELAY_MSG_RESIZE
+ * on the control socket (the one direct mode was declined on) instead.
+ * The signal handler only writes to a self-pipe that poll() watches, so
+ * an idle relay sleeps in poll() with no timeout and a resize is
+ * forwarded within one wakeup.
+ *
+ * Set CELS_NCURSES_RELAY_STATS=<path> to write throughput statistics to
+ * that file when the relay exits.
  */
 
-static volatile sig_atomic_t g_relay_winch = 0;
+#define RELAY_BUF_MIN       (16 * 1024)
+#define RELAY_BUF_MAX       (256 * 1024)
+#define RELAY_SHRINK_AFTER  64              /* Light reads before halving */
+#define RELAY_PIPE_SIZE     (256 * 1024)
+#define RELAY_INPUT_BUF     4096
+#define RELAY_MSG_RESIZE    'W'             /* Control socket: slave resized */
+
+typedef struct RelayStats {
+    uint64_t start_ns;
+    uint64_t bytes_out;         /* Slave PTY -> terminal */
+    uint64_t bytes_in;          /* Terminal -> slave PTY */
+    uint64_t chunks_out;        /* Reads (or splices) on the output path */
+    uint64_t max_chunk;
+    uint64_t window_ns;         /* Start of the current one-second window */
+    uint64_t window_bytes;
+    uint64_t peak_bps;          /* Best one-second output rate */
+    size_t buf_max;             /* Largest copy buffer used */
+} RelayStats;
+
+static int g_relay_winch_pipe[2] = { -1, -1 };  /* SIGWINCH self-pipe */
 static int g_relay_slave_fd = -1;
+static RelayStats g_relay_stats;
+
+static char* g_relay_buf = NULL;            /* Copy-path output buffer */
+static size_t g_relay_buf_size = 0;
+static int g_relay_light_reads = 0;
+
+#if defined(__linux__)
+static int g_relay_pipe[2] = { -1, -1 };    /* splice() staging pipe */
+#endif
+static bool g_relay_splice = false;
 
 static void relay_sigwinch_handler(int sig) {
     (void)sig;
-    g_relay_winch = 1;
+    int saved = errno;
+    char byte = 1;
+    if (write(g_relay_winch_pipe[1], &byte, 1) < 0) { /* Already pending */ }
+    errno = saved;
 }
 
 static void relay_propagate_winch(int slave_fd) {
@@ -137,7 +200,150 @@ static void relay_propagate_winch(int slave_fd) {
     }
 }
 
-static int run_pty_relay(const char* slave_path) {
+static uint64_t relay_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void relay_count_out(size_t n) {
+    RelayStats* st = &g_relay_stats;
+    st->bytes_out += n;
+    st->chunks_out++;
+    if (n > st->max_chunk) st->max_chunk = n;
+
+    uint64_t now = relay_now_ns();
+    if (now - st->window_ns >= 1000000000ull) {
+        uint64_t bps = st->window_bytes * 1000000000ull / (now - st->window_ns);
+        if (bps > st->peak_bps) st->peak_bps = bps;
+        st->window_ns = now;
+        st->window_bytes = 0;
+    }
+    st->window_bytes += n;
+}
+
+static bool relay_write_all(int fd, const char* buf, size_t n) {
+    size_t written = 0;
+    while (written < n) {
+        ssize_t w = write(fd, buf + written, n - written);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return false;
+        written += (size_t)w;
+    }
+    return true;
+}
+
+/* Output through the copy buffer: grow when a read fills it, halve after a
+ * run of reads that used less than a quarter. Returns false at EOF/error. */
+static bool relay_copy_out(int slave_fd) {
+    ssize_t n = read(slave_fd, g_relay_buf, g_relay_buf_size);
+    if (n < 0 && errno == EINTR) return true;
+    if (n <= 0) return false; /* master closed */
+    if (!relay_write_all(STDOUT_FILENO, g_relay_buf, (size_t)n)) return false;
+    relay_count_out((size_t)n);
+
+    size_t next = g_relay_buf_size;
+    if ((size_t)n == g_relay_buf_size && g_relay_buf_size < RELAY_BUF_MAX) {
+        next = g_relay_buf_size * 2;
+        g_relay_light_reads = 0;
+    } else if ((size_t)n < g_relay_buf_size / 4 && g_relay_buf_size > RELAY_BUF_MIN) {
+        if (++g_relay_light_reads >= RELAY_SHRINK_AFTER) next = g_relay_buf_size / 2;
+    } else {
+        g_relay_light_reads = 0;
+    }
+    if (next != g_relay_buf_size) {
+        char* resized = realloc(g_relay_buf, next);
+        if (resized) {
+            g_relay_buf = resized;
+            g_relay_buf_size = next;
+            if (next > g_relay_stats.buf_max) g_relay_stats.buf_max = next;
+        }
+        g_relay_light_reads = 0;
+    }
+    return true;
+}
+
+#if defined(__linux__)
+/* Output via splice(): slave PTY -> pipe -> stdout. Returns false at
+ * EOF/error; clears g_relay_splice (caller retries with the copy path) if
+ * the kernel cannot splice these fds. */
+static bool relay_splice_out(int slave_fd) {
+    ssize_t n = splice(slave_fd, NULL, g_relay_pipe[1], NULL, RELAY_PIPE_SIZE,
+                       SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    if (n < 0 && (errno == EINTR || errno == EAGAIN)) return true;
+    if (n < 0 && errno == EINVAL) {
+        g_relay_splice = false;
+        return true;
+    }
+    if (n <= 0) return false; /* master closed */
+
+    size_t left = (size_t)n;
+    while (left > 0) {
+        ssize_t m = splice(g_relay_pipe[0], NULL, STDOUT_FILENO, NULL, left, SPLICE_F_MOVE);
+        if (m < 0 && errno == EINTR) continue;
+        if (m < 0 && errno == EINVAL) {
+            /* stdout cannot take a splice: drain the pipe by copying */
+            g_relay_splice = false;
+            while (left > 0) {
+                ssize_t r = read(g_relay_pipe[0], g_relay_buf,
+                                 left < g_relay_buf_size ? left : g_relay_buf_size);
+                if (r < 0 && errno == EINTR) continue;
+                if (r <= 0 || !relay_write_all(STDOUT_FILENO, g_relay_buf, (size_t)r)) {
+                    return false;
+                }
+                left -= (size_t)r;
+            }
+            break;
+        }
+        if (m <= 0) return false;
+        left -= (size_t)m;
+    }
+    relay_count_out((size_t)n);
+    return true;
+}
+
+static void relay_splice_init(void) {
+    if (pipe(g_relay_pipe) != 0) return;
+    fcntl(g_relay_pipe[0], F_SETFD, FD_CLOEXEC);
+    fcntl(g_relay_pipe[1], F_SETFD, FD_CLOEXEC);
+    fcntl(g_relay_pipe[1], F_SETPIPE_SZ, RELAY_PIPE_SIZE);   /* Best effort */
+    g_relay_splice = true;
+}
+#endif
+
+static void relay_stats_dump(void) {
+    const char* path = getenv("CELS_NCURSES_RELAY_STATS");
+    if (!path || !path[0]) return;
+    FILE* f = fopen(path, "w");
+    if (!f) return;
+
+    const RelayStats* st = &g_relay_stats;
+    uint64_t elapsed = relay_now_ns() - st->start_ns;
+    uint64_t avg_bps = elapsed ? st->bytes_out * 1000000000ull / elapsed : 0;
+    uint64_t peak_bps = st->peak_bps ? st->peak_bps : avg_bps;
+    fprintf(f, "# cels-ncurses PTY relay throughput\n");
+    fprintf(f, "mode %s\n", g_relay_splice ? "splice" : "copy");
+    fprintf(f, "seconds %.3f\n", (double)elapsed / 1e9);
+    fprintf(f, "bytes_out %llu\n", (unsigned long long)st->bytes_out);
+    fprintf(f, "bytes_in %llu\n", (unsigned long long)st->bytes_in);
+    fprintf(f, "chunks_out %llu\n", (unsigned long long)st->chunks_out);
+    fprintf(f, "max_chunk %llu\n", (unsigned long long)st->max_chunk);
+    fprintf(f, "avg_out_bps %llu\n", (unsigned long long)avg_bps);
+    fprintf(f, "peak_out_bps %llu\n", (unsigned long long)peak_bps);
+    fprintf(f, "copy_buf_max %zu\n", st->buf_max);
+    fclose(f);
+}
+
+/* Set the slave's size from the emulator's, then tell the application */
+static void relay_resize(int slave_fd, int ctrl_fd) {
+    relay_propagate_winch(slave_fd);
+    if (ctrl_fd >= 0) {
+        char msg = RELAY_MSG_RESIZE;
+        if (send(ctrl_fd, &msg, 1, MSG_DONTWAIT) < 0) { /* Application gone */ }
+    }
+}
+
+static int run_pty_relay(const char* slave_path, int ctrl_fd) {
     /* Open our slave PTY */
     int slave_fd = open(slave_path, O_RDWR | O_NOCTTY);
     if (slave_fd < 0) {
@@ -154,69 +360,209 @@ static int run_pty_relay(const char* slave_path) {
     raw.c_cc[VTIME] = 0;
     tcsetattr(STDIN_FILENO, TCSANOW, &raw);
 
-    /* Propagate initial window size */
-    relay_propagate_winch(slave_fd);
-
     /* Install SIGWINCH handler for resize propagation */
+    if (pipe(g_relay_winch_pipe) != 0) {
+        close(slave_fd);
+        return 1;
+    }
+    for (int i = 0; i < 2; i++) {
+        fcntl(g_relay_winch_pipe[i], F_SETFL, fcntl(g_relay_winch_pipe[i], F_GETFL) | O_NONBLOCK);
+        fcntl(g_relay_winch_pipe[i], F_SETFD, FD_CLOEXEC);
+    }
     struct sigaction sa = { .sa_handler = relay_sigwinch_handler };
     sigemptyset(&sa.sa_mask);
     sa.sa_flags = SA_RESTART;
     sigaction(SIGWINCH, &sa, NULL);
 
-    /* select() loop: bridge stdin ↔ slave_fd */
-    char buf[4096];
-    int maxfd = (STDIN_FILENO > slave_fd ? STDIN_FILENO : slave_fd) + 1;
+    /* Propagate initial window size (the application may already have
+     * read the slave's size before this) */
+    relay_resize(slave_fd, ctrl_fd);
 
-    for (;;) {
-        /* Handle pending SIGWINCH */
-        if (g_relay_winch) {
-            g_relay_winch = 0;
-            relay_propagate_winch(slave_fd);
-        }
+    memset(&g_relay_stats, 0, sizeof(g_relay_stats));
+    g_relay_stats.start_ns = relay_now_ns();
+    g_relay_stats.window_ns = g_relay_stats.start_ns;
+    g_relay_buf_size = RELAY_BUF_MIN;
+    g_relay_buf = malloc(g_relay_buf_size);
+    if (!g_relay_buf) {
+        close(slave_fd);
+        return 1;
+    }
+    g_relay_stats.buf_max = g_relay_buf_size;
+#if defined(__linux__)
+    relay_splice_init();
+#endif
 
-        fd_set rfds;
-        FD_ZERO(&rfds);
-        FD_SET(STDIN_FILENO, &rfds);
-        FD_SET(slave_fd, &rfds);
+    /* poll() loop: bridge stdin <-> slave_fd */
+    char in_buf[RELAY_INPUT_BUF];
 
-        /* Use a timeout so we can check SIGWINCH flag periodically */
-        struct timeval tv = { .tv_sec = 0, .tv_usec = 50000 }; /* 50ms */
+    for (;;) {
+        struct pollfd pfd[3] = {
+            { .fd = STDIN_FILENO, .events = POLLIN },
+            { .fd = slave_fd, .events = POLLIN },
+            { .fd = g_relay_winch_pipe[0], .events = POLLIN },
+        };
 
-        int ret = select(maxfd, &rfds, NULL, NULL, &tv);
+        int ret = poll(pfd, 3, -1);
         if (ret < 0) {
             if (errno == EINTR) continue;
             break;
         }
 
+        /* Pending SIGWINCH (one resize for any number of signals) */
+        if (pfd[2].revents & POLLIN) {
+            char drain[16];
+            while (read(g_relay_winch_pipe[0], drain, sizeof(drain)) > 0) { /* empty */ }
+            relay_resize(slave_fd, ctrl_fd);
+        }
+
         /* Terminal input → slave PTY (user keystrokes → ncurses) */
-        if (FD_ISSET(STDIN_FILENO, &rfds)) {
-            ssize_t n = read(STDIN_FILENO, buf, sizeof(buf));
+        if (pfd[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+            ssize_t n = read(STDIN_FILENO, in_buf, sizeof(in_buf));
+            if (n < 0 && errno == EINTR) continue;
             if (n <= 0) break; /* terminal closed */
-            ssize_t written = 0;
-            while (written < n) {
-                ssize_t w = write(slave_fd, buf + written, (size_t)(n - written));
-                if (w <= 0) goto done;
-                written += w;
-            }
+            if (!relay_write_all(slave_fd, in_buf, (size_t)n)) break;
+            g_relay_stats.bytes_in += (uint64_t)n;
         }
 
         /* Slave PTY → terminal output (ncurses rendering → display) */
-        if (FD_ISSET(slave_fd, &rfds)) {
-            ssize_t n = read(slave_fd, buf, sizeof(buf));
-            if (n <= 0) break; /* master closed */
-            ssize_t written = 0;
-            while (written < n) {
-                ssize_t w = write(STDOUT_FILENO, buf + written, (size_t)(n - written));
-                if (w <= 0) goto done;
-                written += w;
+        if (pfd[1].revents & (POLLIN | POLLHUP | POLLERR)) {
+            bool ok;
+#if defined(__linux__)
+            if (g_relay_splice) {
+                ok = relay_splice_out(slave_fd);
+                if (ok && !g_relay_splice) ok = relay_copy_out(slave_fd);
+            } else {
+                ok = relay_copy_out(slave_fd);
             }
+#else
+            ok = relay_copy_out(slave_fd);
+#endif
+            if (!ok) break;
         }
     }
-done:
+
+    relay_stats_dump();
+    free(g_relay_buf);
+    g_relay_buf = NULL;
+#if defined(__linux__)
+    if (g_relay_pipe[0] >= 0) close(g_relay_pipe[0]);
+    if (g_relay_pipe[1] >= 0) close(g_relay_pipe[1]);
+#endif
     close(slave_fd);
     return 0;
 }
 
+/* ============================================================================
+ * Direct Mode -- relay hands its tty to the application
+ * ============================================================================
+ *
+ * With CELS_NCURSES_PTY_DIRECT set to the application's Unix socket, the
+ * relay first offers the emulator's tty instead of bridging it: it sends
+ * its stdin and stdout fds with SCM_RIGHTS and waits for a one-byte ack.
+ * The offer carries CELS_NCURSES_PTY_SPAWNER, the pid of the fork that
+ * launched its emulator, so a late relay from an abandoned candidate is
+ * told apart from the one just spawned and exits.
+ * After the ack the application renders straight to the emulator, and the
+ * relay only keeps the window open until the application closes the socket.
+ *
+ * The relay stays the tty's foreground process, so it is the one that
+ * receives the emulator's SIGWINCH (and SIGINT from Ctrl+C in cbreak mode).
+ * It forwards both to the application (CELS_NCURSES_PTY_PARENT).
+ *
+ * If the application declines (CELS_NCURSES_PTY_MODE=relay) the relay
+ * keeps the socket as its control channel and runs run_pty_relay(). With
+ * no answer at all -- no socket, or the application gave up waiting --
+ * it runs run_pty_relay() without one.
+ */
+
+#define DIRECT_MSG     'D'
+#define DIRECT_ACK     'A'
+#define DIRECT_DECLINE 'R'
+#define DIRECT_STALE   'X'      /* Offer from an abandoned spawn attempt */
+#define DIRECT_MSG_LEN (1 + sizeof(int64_t))    /* Tag + spawner pid */
+
+/* A relay's offer, received while spawning and answered by direct_accept() */
+typedef struct DirectOffer {
+    pid_t spawner;      /* Fork that launched the accepted emulator */
+    int conn;           /* -1 until the relay's offer arrived */
+    int fds[2];         /* Emulator stdin / stdout (-1 if not sent) */
+    char tag;
+} DirectOffer;
+
+static pid_t g_direct_parent = 0;
+
+static void direct_forward_signal(int sig) {
+    if (g_direct_parent > 0) kill(g_direct_parent, sig);
+}
+
+/* Returns true once the application took the tty and then let go of it.
+ * If it declined, *ctrl_fd is the socket to send resize messages on. */
+static bool run_direct_relay(const char* sock_path, pid_t parent, int64_t spawner,
+                             int* ctrl_fd) {
+    if (parent <= 0 || strlen(sock_path) >= sizeof(((struct sockaddr_un*)0)->sun_path)) {
+        return false;
+    }
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock < 0) return false;
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    strcpy(addr.sun_path, sock_path);
+    if (connect(sock, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(sock);
+        return false;
+    }
+
+    int fds[2] = { STDIN_FILENO, STDOUT_FILENO };
+    unsigned char body[DIRECT_MSG_LEN];
+    body[0] = DIRECT_MSG;
+    memcpy(body + 1, &spawner, sizeof(spawner));
+    struct iovec iov = { .iov_base = body, .iov_len = sizeof(body) };
+    union {
+        char buf[CMSG_SPACE(sizeof(fds))];
+        struct cmsghdr align;
+    } ctrl;
+    memset(&ctrl, 0, sizeof(ctrl));
+    struct msghdr msg = {
+        .msg_iov = &iov, .msg_iovlen = 1,
+        .msg_control = ctrl.buf, .msg_controllen = sizeof(ctrl.buf),
+    };
+    struct cmsghdr* cm = CMSG_FIRSTHDR(&msg);
+    cm->cmsg_level = SOL_SOCKET;
+    cm->cmsg_type = SCM_RIGHTS;
+    cm->cmsg_len = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cm), fds, sizeof(fds));
+
+    char ack = 0;
+    if (sendmsg(sock, &msg, 0) != (ssize_t)sizeof(body)
+        || read(sock, &ack, 1) != 1 || ack != DIRECT_ACK) {
+        if (ack == DIRECT_STALE) _exit(0);     /* Another emulator won */
+        if (ack == DIRECT_DECLINE) {
+            fcntl(sock, F_SETFD, FD_CLOEXEC);
+            *ctrl_fd = sock;
+        } else {
+            close(sock);
+        }
+        return false;
+    }
+
+    g_direct_parent = parent;
+    struct sigaction sa = { .sa_handler = direct_forward_signal };
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+    sigaction(SIGWINCH, &sa, NULL);
+    sigaction(SIGINT, &sa, NULL);
+    signal(SIGQUIT, SIG_IGN);
+    signal(SIGTSTP, SIG_IGN);
+
+    /* Wait for the application to close the socket (shutdown or exit) */
+    char buf[64];
+    for (;;) {
+        ssize_t n = read(sock, buf, sizeof(buf));
+        if (n == 0 || (n < 0 && errno != EINTR)) break;
+    }
+    close(sock);
+    return true;
+}
+
 /*
  * Constructor: check if we're a relay process.
  *
@@ -228,7 +574,15 @@ __attribute__((constructor))
 static void ncurses_check_pty_relay(void) {
     const char* slave_path = getenv("CELS_NCURSES_PTY_RELAY");
     if (slave_path && slave_path[0]) {
-        int rc = run_pty_relay(slave_path);
+        const char* direct = getenv("CELS_NCURSES_PTY_DIRECT");
+        const char* parent = getenv("CELS_NCURSES_PTY_PARENT");
+        const char* spawner = getenv("CELS_NCURSES_PTY_SPAWNER");
+        int ctrl_fd = -1;
+        if (direct && direct[0] && parent && spawner
+            && run_direct_relay(direct, (pid_t)atol(parent), atoll(spawner), &ctrl_fd)) {
+            _exit(0);
+        }
+        int rc = run_pty_relay(slave_path, ctrl_fd);
         _exit(rc);
     }
 }
@@ -239,7 +593,16 @@ static void ncurses_check_pty_relay(void) {
 
 static pid_t g_terminal_pid = -1;
 
+/* Connection to the relay. Direct mode: closing it lets the relay exit.
+ * PTY mode: the relay's resize notifications (non-blocking). */
+static int g_relay_sock = -1;
+static bool g_relay_direct = false;
+
 void ncurses_kill_terminal(void) {
+    if (g_relay_sock >= 0) {
+        close(g_relay_sock);
+        g_relay_sock = -1;
+    }
     if (g_terminal_pid > 0) {
         kill(g_terminal_pid, SIGTERM);
         waitpid(g_terminal_pid, NULL, 0);
@@ -249,37 +612,134 @@ void ncurses_kill_terminal(void) {
 
 /* ============================================================================
  * Terminal candidate list per platform
- * ============================================================================ */
+ * ============================================================================
+ *
+ * Candidates are found by name on $PATH, then in the platform's usual
+ * install directories (apps started from a desktop launcher often get a
+ * minimal $PATH). The emulator that last started is remembered in a cache
+ * file and tried first next time.
+ */
 
 typedef struct {
     const char* name;
-    const char* path;
     const char* title_flag;  /* NULL if unsupported */
 } TermCandidate;
 
 #if defined(__linux__)
 static const TermCandidate g_terminals[] = {
-    { "kitty",          "/usr/bin/kitty",            "--title" },
-    { "alacritty",      "/usr/bin/alacritty",        "--title" },
-    { "xterm",          "/usr/bin/xterm",            "-title"  },
-    { "gnome-terminal", "/usr/bin/gnome-terminal",   "--title" },
-    { "konsole",        "/usr/bin/konsole",          NULL      },
-    { NULL, NULL, NULL }
+    { "kitty",          "--title" },
+    { "alacritty",      "--title" },
+    { "xterm",          "-title"  },
+    { "gnome-terminal", "--title" },
+    { "konsole",        NULL      },
+    { NULL, NULL }
 };
+static const char* const g_terminal_dirs[] = { "/usr/bin", "/usr/local/bin", NULL };
 #elif defined(__APPLE__)
 static const TermCandidate g_terminals[] = {
-    { "kitty",     "/usr/local/bin/kitty",              "--title" },
-    { "kitty",     "/opt/homebrew/bin/kitty",           "--title" },
-    { "alacritty", "/usr/local/bin/alacritty",          "--title" },
-    { "alacritty", "/opt/homebrew/bin/alacritty",       "--title" },
-    { NULL, NULL, NULL }
+    { "kitty",     "--title" },
+    { "alacritty", "--title" },
+    { NULL, NULL }
 };
+static const char* const g_terminal_dirs[] = { "/usr/local/bin", "/opt/homebrew/bin", NULL };
 #else
 static const TermCandidate g_terminals[] = {
-    { NULL, NULL, NULL }
+    { NULL, NULL }
 };
+static const char* const g_terminal_dirs[] = { NULL };
 #endif
 
+static bool term_try_dir(const char* dir, size_t dir_len, const char* name,
+                         char* out, size_t out_len) {
+    if (dir_len == 0) { dir = "."; dir_len = 1; }   /* Empty $PATH entry */
+    int n = snprintf(out, out_len, "%.*s/%s", (int)dir_len, dir, name);
+    return n > 0 && (size_t)n < out_len && access(out, X_OK) == 0;
+}
+
+/* Resolve an emulator name to an executable path */
+static bool term_find(const char* name, char* out, size_t out_len) {
+    const char* path = getenv("PATH");
+    while (path && *path) {
+        const char* end = strchr(path, ':');
+        size_t len = end ? (size_t)(end - path) : strlen(path);
+        if (term_try_dir(path, len, name, out, out_len)) return true;
+        if (!end) break;
+        path = end + 1;
+    }
+    for (int i = 0; g_terminal_dirs[i]; i++) {
+        if (term_try_dir(g_terminal_dirs[i], strlen(g_terminal_dirs[i]),
+                         name, out, out_len)) return true;
+    }
+    return false;
+}
+
+/* $XDG_CACHE_HOME/cels-ncurses/terminal (or ~/.cache/...). dir_len is
+ * the length of the directory part. */
+static bool term_cache_file(char* out, size_t out_len, size_t* dir_len) {
+    const char* base = getenv("XDG_CACHE_HOME");
+    const char* home = getenv("HOME");
+    int n;
+    if (base && base[0] == '/') {
+        n = snprintf(out, out_len, "%s/cels-ncurses/terminal", base);
+    } else if (home && home[0]) {
+        n = snprintf(out, out_len, "%s/.cache/cels-ncurses/terminal", home);
+    } else {
+        return false;
+    }
+    if (n <= 0 || (size_t)n >= out_len) return false;
+    *dir_len = (size_t)n - strlen("/terminal");
+    return true;
+}
+
+/* Cache format: "<name>\n<path>\n". Only an entry that is still one of our
+ * candidates and still executable is returned. */
+static const TermCandidate* term_cache_read(char* path, size_t path_len) {
+    char file[512];
+    size_t dir_len;
+    if (!term_cache_file(file, sizeof(file), &dir_len)) return NULL;
+    FILE* f = fopen(file, "r");
+    if (!f) return NULL;
+
+    char name[64];
+    bool ok = fgets(name, sizeof(name), f) && fgets(path, (int)path_len, f);
+    fclose(f);
+    if (!ok) return NULL;
+    name[strcspn(name, "\n")] = '\0';
+    path[strcspn(path, "\n")] = '\0';
+    if (path[0] != '/' || access(path, X_OK) != 0) return NULL;
+
+    for (int i = 0; g_terminals[i].name; i++) {
+        if (strcmp(g_terminals[i].name, name) == 0) return &g_terminals[i];
+    }
+    return NULL;
+}
+
+static void term_cache_write(const char* name, const char* path) {
+    char file[512], tmp[528];
+    size_t dir_len;
+    if (!term_cache_file(file, sizeof(file), &dir_len)) return;
+
+    /* Create the directory and, for ~/.cache, its parent */
+    char dir[512];
+    memcpy(dir, file, dir_len);
+    dir[dir_len] = '\0';
+    if (mkdir(dir, 0700) != 0 && errno == ENOENT) {
+        char* slash = strrchr(dir, '/');
+        *slash = '\0';
+        mkdir(dir, 0700);
+        *slash = '/';
+        mkdir(dir, 0700);
+    }
+
+    /* Write-then-rename so concurrent starts never read half a file */
+    snprintf(tmp, sizeof(tmp), "%s.%ld", file, (long)getpid());
+    FILE* f = fopen(tmp, "w");
+    if (!f) return;
+    bool ok = fprintf(f, "%s\n%s\n", name, path) > 0;
+    ok = fclose(f) == 0 && ok;
+    if (!ok || rename(tmp, file) != 0) unlink(tmp);
+}
+
 /* ============================================================================
  * PTY-based terminal spawning
  * ============================================================================
@@ -288,46 +748,295 @@ static const TermCandidate g_terminals[] = {
  * as a PTY relay. The terminal runs: our_binary (with env var set).
  * The constructor detects the env var and runs the relay loop.
  *
- * Returns child pid on success, -1 on failure.
+ * Readiness is reported, not guessed:
+ *   - A close-on-exec status pipe: EOF means exec succeeded, an errno
+ *     value means it failed. A missing emulator fails immediately.
+ *   - The relay connecting to listen_fd means it is up. Startup returns
+ *     as soon as that happens.
+ *   - Launchers such as gnome-terminal hand the window to a server and
+ *     exit 0 right away. That is not a failure: the relay still connects,
+ *     though a cold server may take a while, so the wait is extended to
+ *     SPAWN_LAUNCHER_TIMEOUT_MS. If it still does not connect, no further
+ *     candidate is tried (its window may yet open, and a second emulator
+ *     would mean two). A non-zero exit before the relay is up is a failure.
+ *   - Only an offer naming this attempt's pid counts (see DirectOffer): a
+ *     relay of a candidate given up on earlier is closed, not accepted.
+ *
+ * Without a socket (listen_fd < 0) there is nothing to wait for: a child
+ * still running SPAWN_GRACE_MS after exec, or a launcher that exited 0,
+ * counts as success. If the relay never connects, a live emulator is kept
+ * after SPAWN_READY_TIMEOUT_MS (the relay then bridges the PTY without a
+ * control channel).
  */
 
-static pid_t try_spawn_pty_terminal(const TermCandidate* term, const char* exe,
-                                    const char* title, const char* slave_path) {
-    if (access(term->path, X_OK) != 0)
-        return -1;
+#define SPAWN_READY_TIMEOUT_MS    3000
+#define SPAWN_LAUNCHER_TIMEOUT_MS 10000
+#define SPAWN_GRACE_MS            200
+#define SPAWN_POLL_MS             50     /* Child exit is only seen by waitpid */
+
+typedef enum SpawnResult {
+    SPAWN_FAILED,           /* Try the next candidate */
+    SPAWN_READY,
+    SPAWN_UNCONFIRMED       /* Launcher exited 0, relay never came: stop */
+} SpawnResult;
+
+static bool direct_receive(int listen_fd, int timeout_ms, DirectOffer* offer);
+
+static int64_t spawn_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static SpawnResult try_spawn_pty_terminal(const TermCandidate* term, const char* term_path,
+                                          const char* exe, const char* title,
+                                          const char* slave_path, const char* direct_path,
+                                          int listen_fd, DirectOffer* offer) {
+    int status_pipe[2];
+    if (pipe(status_pipe) != 0)
+        return SPAWN_FAILED;
+    fcntl(status_pipe[0], F_SETFD, FD_CLOEXEC);
+    fcntl(status_pipe[1], F_SETFD, FD_CLOEXEC);
 
     pid_t pid = fork();
-    if (pid < 0)
-        return -1;
+    if (pid < 0) {
+        close(status_pipe[0]);
+        close(status_pipe[1]);
+        return SPAWN_FAILED;
+    }
 
     if (pid == 0) {
         /* Child: set relay env var and exec terminal running our binary */
+        close(status_pipe[0]);
         setenv("CELS_NCURSES_PTY_RELAY", slave_path, 1);
+        if (direct_path) {
+            char parent[32], spawner[32];
+            snprintf(parent, sizeof(parent), "%ld", (long)getppid());
+            snprintf(spawner, sizeof(spawner), "%ld", (long)getpid());
+            setenv("CELS_NCURSES_PTY_DIRECT", direct_path, 1);
+            setenv("CELS_NCURSES_PTY_PARENT", parent, 1);
+            setenv("CELS_NCURSES_PTY_SPAWNER", spawner, 1);
+        }
 
         if (term->title_flag && title) {
-            execl(term->path, term->path,
+            execl(term_path, term_path,
                   term->title_flag, title,
                   "-e", exe,
                   (char*)NULL);
         } else {
-            execl(term->path, term->path,
+            execl(term_path, term_path,
                   "-e", exe,
                   (char*)NULL);
         }
+        int err = errno;
+        ssize_t w = write(status_pipe[1], &err, sizeof(err));
+        (void)w;
         _exit(127);
     }
 
-    /* Parent: briefly check if child survived exec */
-    usleep(200000); /* 200ms -- give terminal time to start */
-    int status;
-    pid_t w = waitpid(pid, &status, WNOHANG);
-    if (w == 0) {
-        /* Child still running = success */
-        g_terminal_pid = pid;
-        return pid;
+    /* Parent: wait for exec status, the relay, or the child exiting */
+    close(status_pipe[1]);
+    int status_fd = status_pipe[0];
+    bool exec_ok = false, child_alive = true, handed_off = false, ready = false;
+    int64_t start = spawn_now_ms();
+    int64_t deadline = start + SPAWN_READY_TIMEOUT_MS;
+    offer->spawner = pid;
+
+    while (!ready) {
+        int64_t now = spawn_now_ms();
+        if (now >= deadline) break;
+        int wait_ms = (int)(deadline - now);
+        if (wait_ms > SPAWN_POLL_MS) wait_ms = SPAWN_POLL_MS;
+
+        struct pollfd pfd[2] = {
+            { .fd = status_fd, .events = POLLIN },
+            { .fd = listen_fd, .events = POLLIN },   /* Ignored when -1 */
+        };
+        if (poll(pfd, 2, wait_ms) < 0 && errno != EINTR) break;
+
+        if (status_fd >= 0 && (pfd[0].revents & (POLLIN | POLLHUP))) {
+            int err = 0;
+            ssize_t n = read(status_fd, &err, sizeof(err));
+            if (n < 0 && errno == EINTR) continue;
+            close(status_fd);
+            status_fd = -1;
+            if (n > 0) {
+                fprintf(stderr, "[NCurses] Cannot run %s: %s\n",
+                        term_path, strerror(err));
+                break;
+            }
+            exec_ok = true;
+            if (listen_fd < 0) deadline = spawn_now_ms() + SPAWN_GRACE_MS;
+        }
+
+        /* Relay connected (stale offers are dropped inside) */
+        if (pfd[1].revents & POLLIN) ready = direct_receive(listen_fd, 0, offer);
+
+        int wstatus;
+        if (child_alive && waitpid(pid, &wstatus, WNOHANG) == pid) {
+            child_alive = false;
+            if (!WIFEXITED(wstatus) || WEXITSTATUS(wstatus) != 0) break;
+            /* Exit 0: a launcher handed the window off */
+            handed_off = true;
+            if (listen_fd < 0) break;
+            deadline = start + SPAWN_LAUNCHER_TIMEOUT_MS;
+        }
     }
+    if (status_fd >= 0) close(status_fd);
 
-    return -1;
+    /* No relay yet: keep an emulator that is demonstrably still running,
+     * or a launcher that handed off with no socket to confirm it on */
+    if (!ready && exec_ok && child_alive && spawn_now_ms() >= deadline)
+        ready = true;
+    if (!ready && handed_off && listen_fd < 0)
+        ready = true;
+
+    if (!ready) {
+        if (child_alive) {
+            kill(pid, SIGTERM);
+            waitpid(pid, NULL, 0);
+        }
+        return handed_off ? SPAWN_UNCONFIRMED : SPAWN_FAILED;
+    }
+
+    g_terminal_pid = child_alive ? pid : -1;
+    return SPAWN_READY;
+}
+
+/* ============================================================================
+ * Direct mode -- receive the emulator's tty from the relay
+ * ============================================================================ */
+
+#define DIRECT_ACCEPT_TIMEOUT_MS 2000
+
+/* Listen on a socket in a fresh private directory (mode 0700). Fills
+ * path/dir for direct_close_listener(). */
+static int direct_listen(char* path, size_t path_len, char* dir, size_t dir_len) {
+    const char* base = getenv("XDG_RUNTIME_DIR");
+    if (!base || !base[0]) base = "/tmp";
+    if (snprintf(dir, dir_len, "%s/cels-ncurses-XXXXXX", base) >= (int)dir_len) return -1;
+    if (!mkdtemp(dir)) return -1;
+
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    int n = snprintf(path, path_len, "%s/tty", dir);
+    if (n < 0 || (size_t)n >= path_len || (size_t)n >= sizeof(addr.sun_path)) {
+        rmdir(dir);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        rmdir(dir);
+        return -1;
+    }
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 1) != 0) {
+        close(fd);
+        unlink(path);
+        rmdir(dir);
+        return -1;
+    }
+    return fd;
+}
+
+static void direct_close_listener(int fd, const char* path, const char* dir) {
+    close(fd);
+    unlink(path);
+    rmdir(dir);
+}
+
+/* Accept relay connections until one offers its tty for offer->spawner,
+ * waiting up to timeout_ms for each step. Offers from other spawn
+ * attempts are closed. */
+static bool direct_receive(int listen_fd, int timeout_ms, DirectOffer* offer) {
+    for (;;) {
+        struct pollfd pfd = { .fd = listen_fd, .events = POLLIN };
+        if (poll(&pfd, 1, timeout_ms) <= 0) return false;
+        int conn = accept(listen_fd, NULL, NULL);
+        if (conn < 0) return false;
+        fcntl(conn, F_SETFD, FD_CLOEXEC);
+
+        int fds[2] = { -1, -1 };
+        unsigned char body[DIRECT_MSG_LEN];
+        struct iovec iov = { .iov_base = body, .iov_len = sizeof(body) };
+        union {
+            char buf[CMSG_SPACE(sizeof(fds))];
+            struct cmsghdr align;
+        } ctrl;
+        struct msghdr msg = {
+            .msg_iov = &iov, .msg_iovlen = 1,
+            .msg_control = ctrl.buf, .msg_controllen = sizeof(ctrl.buf),
+        };
+        pfd.fd = conn;
+        bool got = poll(&pfd, 1, DIRECT_ACCEPT_TIMEOUT_MS) > 0
+                && recvmsg(conn, &msg, 0) == (ssize_t)sizeof(body);
+
+        struct cmsghdr* cm = got ? CMSG_FIRSTHDR(&msg) : NULL;
+        if (cm && cm->cmsg_level == SOL_SOCKET && cm->cmsg_type == SCM_RIGHTS
+            && cm->cmsg_len == CMSG_LEN(sizeof(fds))) {
+            memcpy(fds, CMSG_DATA(cm), sizeof(fds));
+        }
+        int64_t spawner = 0;
+        if (got) memcpy(&spawner, body + 1, sizeof(spawner));
+        if (got && spawner == (int64_t)offer->spawner) {
+            offer->conn = conn;
+            offer->fds[0] = fds[0];
+            offer->fds[1] = fds[1];
+            offer->tag = (char)body[0];
+            return true;
+        }
+
+        /* Stale relay from an abandoned candidate, or garbage */
+        if (got) {
+            char answer = DIRECT_STALE;
+            ssize_t w = write(conn, &answer, 1);
+            (void)w;
+        }
+        if (fds[0] >= 0) close(fds[0]);
+        if (fds[1] >= 0) close(fds[1]);
+        close(conn);
+    }
+}
+
+/* Answer the relay's tty offer (waiting for it if spawning did not see
+ * it). With take, a valid offer is acked and *in_fd / *out_fd are the
+ * emulator's stdin / stdout (returns true). Otherwise the offer is
+ * declined and the connection kept as the relay's control channel (see
+ * ncurses_terminal_control_resized). */
+static bool direct_accept(int listen_fd, DirectOffer* offer, bool take,
+                          int* in_fd, int* out_fd) {
+    if (offer->conn < 0 && !direct_receive(listen_fd, DIRECT_ACCEPT_TIMEOUT_MS, offer)) {
+        return false;
+    }
+    int conn = offer->conn;
+    int fds[2] = { offer->fds[0], offer->fds[1] };
+    char tag = offer->tag;
+    offer->conn = -1;
+
+    take = take && tag == DIRECT_MSG && fds[0] >= 0 && fds[1] >= 0 && isatty(fds[1]);
+    char answer = take ? DIRECT_ACK : DIRECT_DECLINE;
+    bool answered = write(conn, &answer, 1) == 1;
+    if (!take || !answered) {
+        if (fds[0] >= 0) close(fds[0]);
+        if (fds[1] >= 0) close(fds[1]);
+        if (!answered) {
+            close(conn);
+            return false;
+        }
+        /* Declined: the relay bridges the PTY and reports resizes here */
+        fcntl(conn, F_SETFL, fcntl(conn, F_GETFL) | O_NONBLOCK);
+        g_relay_sock = conn;
+        return false;
+    }
+
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    g_relay_sock = conn;
+    g_relay_direct = true;
+    *in_fd = fds[0];
+    *out_fd = fds[1];
+    return true;
 }
 
 #endif /* __linux__ || __APPLE__ */
@@ -337,12 +1046,35 @@ static pid_t try_spawn_pty_terminal(const TermCandidate* term, const char* exe,
  * ============================================================================
  *
  * Creates a PTY pair and spawns a terminal emulator connected to it.
- * Returns the master fd for use with newterm(). Returns -1 if spawning
- * is disabled or fails (caller should fall back to initscr).
+ * Returns the fd for ncurses to write to (see newterm()), or -1 if
+ * spawning is disabled or fails (caller should fall back to initscr).
+ *
+ * Direct mode (default): the relay hands over the emulator's own tty, the
+ * return value is its stdout and *direct_in_fd its stdin. Resizes arrive
+ * as SIGWINCH forwarded by the relay. If the handoff does not happen (or
+ * CELS_NCURSES_PTY_MODE=relay), the relay bridges the PTY instead: the
+ * return value is the PTY master and *direct_in_fd is -1. Resizes are then
+ * announced on ncurses_terminal_control_fd(), if the relay connected.
+ *
+ * Headless session (CELS_NCURSES_SESSION): returns the session's PTY
+ * master. Client sizes are announced on ncurses_terminal_control_fd().
  */
 
-int ncurses_spawn_terminal_pty(const char* window_title) {
+int ncurses_spawn_terminal_pty(const char* window_title, int* direct_in_fd) {
+    *direct_in_fd = -1;
 #if defined(__linux__) || defined(__APPLE__)
+    /* Headless session: no emulator, a PTY served to attach clients */
+    const char* session = getenv("CELS_NCURSES_SESSION");
+    if (session && session[0]) {
+        extern int ncurses_session_start(const char* sock_path, int* control_fd);
+        int control_fd;
+        int master_fd = ncurses_session_start(session, &control_fd);
+        if (master_fd < 0) return -1;
+        fcntl(control_fd, F_SETFL, fcntl(control_fd, F_GETFL) | O_NONBLOCK);
+        g_relay_sock = control_fd;
+        return master_fd;
+    }
+
     const char* term_pref = getenv("CELS_NCURSES_TERMINAL");
     if (term_pref && strcmp(term_pref, "none") == 0)
         return -1;
@@ -362,6 +1094,9 @@ int ncurses_spawn_terminal_pty(const char* window_title) {
         fprintf(stderr, "[NCurses] openpty() failed\n");
         return -1;
     }
+    /* Emulators must not inherit the master: a relay that shows up after
+     * we gave up on it then finds the PTY gone and exits */
+    fcntl(master_fd, F_SETFD, FD_CLOEXEC);
 
     /* Get slave path for the relay to open */
     char* slave_path = ttyname(slave_fd);
@@ -378,41 +1113,129 @@ int ncurses_spawn_terminal_pty(const char* window_title) {
     /* Close slave in parent -- the relay child opens it via path */
     close(slave_fd);
 
-    /* Try to spawn a terminal emulator */
+    /* Socket the relay offers the emulator's tty on (and, if we decline,
+     * reports resizes on) */
+    const char* mode = getenv("CELS_NCURSES_PTY_MODE");
+    bool take_tty = !mode || strcmp(mode, "relay") != 0;
+    char direct_path[256], direct_dir[192];
+    int listen_fd = direct_listen(direct_path, sizeof(direct_path),
+                                  direct_dir, sizeof(direct_dir));
+    const char* offer_path = listen_fd >= 0 ? direct_path : NULL;
+
+    /* Try to spawn a terminal emulator, the one that worked last time first */
+    char term_path[4096], cached_path[4096];
+    const TermCandidate* cached = term_cache_read(cached_path, sizeof(cached_path));
+    const TermCandidate* spawned = NULL;
+    SpawnResult result = SPAWN_FAILED;
+    DirectOffer offer = { .spawner = -1, .conn = -1, .fds = { -1, -1 } };
     if (term_pref && term_pref[0]) {
         /* User specified a terminal */
         for (int i = 0; g_terminals[i].name; i++) {
-            if (strcmp(g_terminals[i].name, term_pref) == 0) {
-                pid_t pid = try_spawn_pty_terminal(&g_terminals[i], exe,
-                                                   title, slave_path_buf);
-                if (pid > 0) {
-                    fprintf(stderr, "[NCurses] Spawned %s window (pid %d): %s\n",
-                            g_terminals[i].name, pid, title);
-                    return master_fd;
-                }
-                fprintf(stderr, "[NCurses] Error: could not launch %s at %s\n",
-                        term_pref, g_terminals[i].path);
+            const TermCandidate* term = &g_terminals[i];
+            if (strcmp(term->name, term_pref) != 0) continue;
+            if (term == cached) {
+                strcpy(term_path, cached_path);
+            } else if (!term_find(term->name, term_path, sizeof(term_path))) {
+                fprintf(stderr, "[NCurses] Error: %s not found on $PATH\n", term_pref);
                 break;
             }
+            result = try_spawn_pty_terminal(term, term_path, exe, title,
+                                            slave_path_buf, offer_path, listen_fd, &offer);
+            if (result == SPAWN_READY) {
+                spawned = term;
+            } else if (result == SPAWN_FAILED) {
+                fprintf(stderr, "[NCurses] Error: could not launch %s at %s\n",
+                        term_pref, term_path);
+            }
+            break;
         }
     } else {
-        /* Auto-detect: try each terminal in order */
-        for (int i = 0; g_terminals[i].name; i++) {
-            pid_t pid = try_spawn_pty_terminal(&g_terminals[i], exe,
-                                               title, slave_path_buf);
-            if (pid > 0) {
-                fprintf(stderr, "[NCurses] Spawned %s window (pid %d): %s\n",
-                        g_terminals[i].name, pid, title);
-                return master_fd;
-            }
+        /* Auto-detect: try the cached terminal, then each one on $PATH */
+        if (cached) {
+            strcpy(term_path, cached_path);
+            result = try_spawn_pty_terminal(cached, term_path, exe, title,
+                                            slave_path_buf, offer_path, listen_fd, &offer);
+            if (result == SPAWN_READY) spawned = cached;
+        }
+        for (int i = 0; g_terminals[i].name && result == SPAWN_FAILED; i++) {
+            if (&g_terminals[i] == cached) continue;
+            if (!term_find(g_terminals[i].name, term_path, sizeof(term_path))) continue;
+            result = try_spawn_pty_terminal(&g_terminals[i], term_path, exe, title,
+                                            slave_path_buf, offer_path, listen_fd, &offer);
+            if (result == SPAWN_READY) spawned = &g_terminals[i];
+        }
+    }
+    if (result == SPAWN_UNCONFIRMED) {
+        fprintf(stderr, "[NCurses] %s exited without its window connecting, "
+                "using current terminal\n", term_path);
+    }
+
+    if (spawned) {
+        fprintf(stderr, "[NCurses] Spawned %s window: %s\n", spawned->name, title);
+        if (spawned != cached || strcmp(term_path, cached_path) != 0)
+            term_cache_write(spawned->name, term_path);
+        int in_fd, out_fd;
+        bool direct = listen_fd >= 0
+                   && direct_accept(listen_fd, &offer, take_tty, &in_fd, &out_fd);
+        if (listen_fd >= 0) direct_close_listener(listen_fd, direct_path, direct_dir);
+        if (direct) {
+            /* The relay never opened the slave: the PTY is unused */
+            close(master_fd);
+            *direct_in_fd = in_fd;
+            return out_fd;
         }
+        return master_fd;
     }
 
     /* No terminal found -- clean up master fd */
+    if (listen_fd >= 0) direct_close_listener(listen_fd, direct_path, direct_dir);
     close(master_fd);
-    fprintf(stderr, "[NCurses] No terminal emulator found, using current terminal\n");
+    if (result == SPAWN_FAILED)
+        fprintf(stderr, "[NCurses] No terminal emulator found, using current terminal\n");
 #else
     (void)window_title;
 #endif
     return -1;
 }
+
+/* ============================================================================
+ * Relay control channel (PTY mode)
+ * ============================================================================
+ *
+ * The frame loop waits on this fd (see tui_hook_frame_end) and calls
+ * ncurses_terminal_control_resized() when it is readable. -1 in direct
+ * mode, without a spawned terminal or session, or once the relay has gone.
+ */
+
+#if defined(__linux__) || defined(__APPLE__)
+
+int ncurses_terminal_control_fd(void) {
+    return g_relay_direct ? -1 : g_relay_sock;
+}
+
+/* Drain pending messages; true if the relay resized the slave PTY */
+bool ncurses_terminal_control_resized(void) {
+    if (g_relay_direct || g_relay_sock < 0) return false;
+    bool resized = false;
+    char msgs[64];
+    for (;;) {
+        ssize_t n = recv(g_relay_sock, msgs, sizeof(msgs), MSG_DONTWAIT);
+        if (n > 0) {
+            if (memchr(msgs, RELAY_MSG_RESIZE, (size_t)n)) resized = true;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+            close(g_relay_sock);    /* Relay exited */
+            g_relay_sock = -1;
+        }
+        return resized;
+    }
+}
+
+#else
+
+int ncurses_terminal_control_fd(void) { return -1; }
+bool ncurses_terminal_control_resized(void) { return false; }
+
+#endif
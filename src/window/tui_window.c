@@ -41,6 +41,7 @@
 #include <time.h>
 #include <stdio.h>
 #include <sys/ioctl.h>
+#include <sys/select.h>
 
 /* ============================================================================
  * Static State
@@ -55,24 +56,50 @@ static cels_entity_t g_window_entity = 0;
 static volatile int g_running = 1;
 static int g_ncurses_active = 0;
 
+/* Input fd ncurses reads from (raw_input reads it directly) */
+static int g_input_fd = STDIN_FILENO;
+
 /* newterm() screen (NULL when using initscr fallback) */
 static SCREEN* g_screen = NULL;
 
 /* PTY master fd for polling resize (-1 when using initscr) */
 static int g_pty_master_fd = -1;
 
+/* Direct mode: the spawned emulator's own tty (-1 otherwise). Its size is
+ * read when the relay forwards SIGWINCH, not polled. */
+static int g_direct_tty_fd = -1;
+
+/* PTY mode: the relay's control socket was readable during the frame wait */
+static bool g_control_ready = false;
+
+/* Stream ncurses writes the terminal through (PTY, output pipe or stdout) */
+static FILE* g_term_out = NULL;
+
 /* Stored FPS from config for frame_end throttle */
 static int g_target_fps = 60;
 
+/* F1 pause: output suspended, frame loop throttled to g_paused_fps */
+static bool g_paused = false;
+static int g_paused_fps = 10;
+
 /* Timing state */
 static struct timespec g_frame_start = {0};
 static struct timespec g_prev_frame_start = {0};
 static float g_delta_time = 1.0f / 60.0f;
 
-/* Cached dimensions for resize detection */
+/* Cached dimensions for resize detection. These are the settled (published)
+ * size: with a resize debounce they lag COLS/LINES until the terminal size
+ * has been stable for g_resize_debounce_ms. */
 static int g_last_cols = 0;
 static int g_last_lines = 0;
 
+/* Resize debounce (0 = publish every size change at once) */
+static int g_resize_debounce_ms = 0;
+static bool g_resize_pending = false;
+static int g_pending_cols = 0;
+static int g_pending_lines = 0;
+static struct timespec g_resize_changed_at = {0};
+
 /* ============================================================================
  * Signal Handlers
  * ============================================================================ */
@@ -83,8 +110,8 @@ static void tui_sigint_handler(int sig) {
 }
 
 /* SIGWINCH: terminal was resized. Flag it for the update system to handle.
- * When using PTY spawn, the relay propagates resize via ioctl(TIOCSWINSZ)
- * which triggers SIGWINCH on the master side. */
+ * With a spawned emulator in direct mode the relay forwards the emulator's
+ * SIGWINCH here; in PTY mode resizes are polled instead. */
 static volatile sig_atomic_t g_sigwinch_pending = 0;
 
 static void tui_sigwinch_handler(int sig) {
@@ -97,17 +124,23 @@ static void tui_sigwinch_handler(int sig) {
  * ============================================================================ */
 
 static void cleanup_endwin(void) {
+    ncurses_latency_dump();
     if (g_ncurses_active && !isendwin()) {
+        ncurses_input_restore_terminal();
         endwin();
         g_ncurses_active = 0;
     }
+    ncurses_output_pipeline_stop();
+    tui_color_forget_pair();
     if (g_screen) {
         delscreen(g_screen);
         g_screen = NULL;
+        g_term_out = NULL;
     }
-    /* Kill the terminal emulator child process */
+    /* Kill the terminal emulator child process, or end the headless session */
     extern void ncurses_kill_terminal(void);
     ncurses_kill_terminal();
+    ncurses_session_stop();
 }
 
 /* ============================================================================
@@ -122,6 +155,35 @@ static void cleanup_endwin(void) {
 void ncurses_window_set_entity(cels_entity_t entity) { g_window_entity = entity; }
 cels_entity_t ncurses_window_get_entity(void) { return g_window_entity; }
 bool ncurses_window_is_active(void) { return g_ncurses_active != 0; }
+bool ncurses_window_is_paused(void) { return g_paused; }
+
+/* Pause/resume (F1, from NCurses_InputSystem). Published to
+ * NCurses_WindowState by NCurses_WindowUpdateSystem the same frame. On
+ * resume the whole screen is repainted once. */
+void ncurses_window_set_paused(bool paused) {
+    if (paused == g_paused) return;
+    g_paused = paused;
+    if (!paused) clearok(curscr, TRUE);
+}
+int ncurses_window_input_fd(void) { return g_input_fd; }
+
+/* Size surfaces lay out against: the settled size, which trails COLS/LINES
+ * while a debounced resize is pending */
+void ncurses_window_layout_size(int* cols, int* lines) {
+    *cols = g_last_cols > 0 ? g_last_cols : COLS;
+    *lines = g_last_lines > 0 ? g_last_lines : LINES;
+}
+
+bool ncurses_window_resize_pending(void) { return g_resize_pending; }
+
+/* Send a raw control sequence (mode switches ncurses has no API for) down
+ * the same stream ncurses writes to. Only call outside doupdate(), e.g.
+ * at init or right before endwin(), so it cannot split ncurses output. */
+void ncurses_terminal_send(const char* seq) {
+    FILE* out = g_term_out ? g_term_out : stdout;
+    fputs(seq, out);
+    fflush(out);
+}
 
 /* ============================================================================
  * Terminal Init (extracted from old tui_hook_startup)
@@ -137,6 +199,7 @@ void ncurses_terminal_init(NCurses_WindowConfig* config) {
     NCurses_WindowState_register();
     NCurses_WindowState.running = true;
     cels_state_bind(NCurses_WindowState);
+    ncurses_latency_init();
 
     signal(SIGINT, tui_sigint_handler);
     signal(SIGWINCH, tui_sigwinch_handler);
@@ -148,22 +211,30 @@ void ncurses_terminal_init(NCurses_WindowConfig* config) {
      * On success we get a master fd and use newterm() so the original
      * process stays alive (debugger attached, stderr → IDE console).
      * On failure (-1) we fall back to initscr() on the current terminal. */
-    extern int ncurses_spawn_terminal_pty(const char* window_title);
-    int pty_master = ncurses_spawn_terminal_pty(config->title);
+    extern int ncurses_spawn_terminal_pty(const char* window_title, int* direct_in_fd);
+    int direct_in_fd = -1;
+    int pty_master = ncurses_spawn_terminal_pty(config->title, &direct_in_fd);
 
     if (pty_master >= 0) {
-        /* PTY path: ncurses renders to the terminal emulator via PTY.
+        /* PTY path: ncurses renders to the terminal emulator via PTY, or
+         * in direct mode straight to the emulator's tty.
          * newterm() needs SEPARATE FILE* for output and input — using
          * the same FILE* causes stdio buffer corruption between reads
          * and writes. dup() the fd so each FILE* has its own buffer. */
-        g_pty_master_fd = pty_master;
-        int pty_in_fd = dup(pty_master);
-        FILE* pty_out = fdopen(pty_master, "w");
+        bool direct = direct_in_fd >= 0;
+        g_pty_master_fd = direct ? -1 : pty_master;
+        int pty_in_fd = direct ? direct_in_fd : dup(pty_master);
+        FILE* pty_out = config->pipelined
+                      ? ncurses_output_pipeline_start(pty_master)
+                      : fdopen(pty_master, "w");
         FILE* pty_in  = fdopen(pty_in_fd, "r");
         if (!pty_out || !pty_in) {
             fprintf(stderr, "[NCurses] fdopen(pty) failed, falling back to initscr\n");
-            if (pty_out) fclose(pty_out); else close(pty_master);
+            ncurses_output_pipeline_stop();
+            if (pty_out) fclose(pty_out);
+            if (!pty_out || config->pipelined) close(pty_master);
             if (pty_in) fclose(pty_in); else close(pty_in_fd);
+            g_pty_master_fd = -1;
             initscr();
         } else {
             /* Disable stdio buffering — ncurses escape sequences must
@@ -172,15 +243,35 @@ void ncurses_terminal_init(NCurses_WindowConfig* config) {
             setvbuf(pty_in, NULL, _IONBF, 0);
 
             g_screen = newterm("xterm-256color", pty_out, pty_in);
+            g_term_out = g_screen ? pty_out : NULL;
             if (!g_screen) {
                 fprintf(stderr, "[NCurses] newterm() failed, falling back to initscr\n");
+                ncurses_output_pipeline_stop();
                 fclose(pty_out);
                 fclose(pty_in);
+                /* The pipe's FILE* does not own the master */
+                if (config->pipelined) close(pty_master);
+                g_pty_master_fd = -1;
                 initscr();
             } else {
                 set_term(g_screen);
+                g_input_fd = pty_in_fd;
+                if (direct) g_direct_tty_fd = pty_in_fd;
             }
         }
+    } else if (config->pipelined) {
+        /* No PTY, pipelined output: newterm() on the current terminal with
+         * the output pipe in place of stdout */
+        FILE* out = ncurses_output_pipeline_start(STDOUT_FILENO);
+        g_screen = out ? newterm(NULL, out, stdin) : NULL;
+        if (g_screen) {
+            g_term_out = out;
+            set_term(g_screen);
+        } else {
+            ncurses_output_pipeline_stop();
+            if (out) fclose(out);
+            initscr();
+        }
     } else {
         /* No PTY: use current terminal directly */
         initscr();
@@ -194,6 +285,10 @@ void ncurses_terminal_init(NCurses_WindowConfig* config) {
     nodelay(stdscr, TRUE);
     ESCDELAY = 25;
 
+    /* Pipelined output: ncurses' tty calls hit the pipe, so apply terminal
+     * modes and size to the real terminal (no-op otherwise) */
+    ncurses_output_pipeline_attach_tty();
+
     if (has_colors()) {
         start_color();
         use_default_colors();
@@ -209,13 +304,17 @@ void ncurses_terminal_init(NCurses_WindowConfig* config) {
 
     g_target_fps = config->fps > 0 ? config->fps : 60;
     g_delta_time = 1.0f / (float)g_target_fps;
+    g_paused_fps = config->paused_fps > 0 ? config->paused_fps : 10;
+    g_paused = false;
+    g_resize_debounce_ms = config->resize_debounce_ms > 0 ? config->resize_debounce_ms : 0;
+    g_resize_pending = false;
 
     /* Cache initial dimensions for resize detection */
     g_last_cols = COLS;
     g_last_lines = LINES;
 
     /* Input: register key sequences and enable mouse (requires active ncurses) */
-    ncurses_input_configure_terminal();
+    ncurses_input_configure_terminal(config);
 
     g_running = 1;
 }
@@ -225,10 +324,38 @@ void ncurses_terminal_init(NCurses_WindowConfig* config) {
  * ============================================================================ */
 
 void ncurses_terminal_shutdown(void) {
+    tui_render_pool_shutdown();
+    ncurses_latency_dump();
     if (g_ncurses_active && !isendwin()) {
+        ncurses_input_restore_terminal();
         endwin();
         g_ncurses_active = 0;
     }
+    ncurses_output_pipeline_stop();
+    tui_color_forget_pair();
+}
+
+/* A session client attached: its terminal has seen none of the modes set
+ * at init. Send them again and repaint the whole screen this frame. */
+static void resume_session_output(void) {
+    static const char* const caps[] = { "smcup", "smkx", "civis" };
+    for (size_t i = 0; i < sizeof(caps) / sizeof(caps[0]); i++) {
+        const char* seq = tigetstr((char*)caps[i]);
+        if (seq && seq != (char*)-1) ncurses_terminal_send(seq);
+    }
+    ncurses_input_resend_modes();
+    clearok(curscr, TRUE);
+}
+
+/* resizeterm() to the size of a terminal ncurses does not watch itself */
+static void apply_terminal_size(int fd) {
+    struct winsize ws;
+    if (ioctl(fd, TIOCGWINSZ, &ws) == 0 && ws.ws_row > 0 && ws.ws_col > 0) {
+        if (ws.ws_col != COLS || ws.ws_row != LINES) {
+            resizeterm(ws.ws_row, ws.ws_col);
+            clearok(curscr, TRUE);
+        }
+    }
 }
 
 /* ============================================================================
@@ -251,46 +378,89 @@ CEL_System(NCurses_WindowUpdateSystem, .phase = PreRender) {
                            (float)(g_frame_start.tv_nsec - g_prev_frame_start.tv_nsec) / 1e9f;
         }
 
-        /* Handle resize: two paths depending on terminal mode.
+        /* Handle resize: three paths depending on terminal mode.
+         *
+         * Spawned emulator, direct mode: the relay forwards the emulator's
+         * SIGWINCH; read the tty's size only then.
          *
          * PTY mode: the relay sets TIOCSWINSZ on the slave, but no SIGWINCH
-         * reaches us (no controlling terminal). Poll the PTY size directly
-         * and call resizeterm() to update ncurses COLS/LINES.
+         * reaches us (no controlling terminal). The relay announces it on
+         * its control socket, which the frame wait watches; read the PTY
+         * size then and call resizeterm() to update ncurses COLS/LINES.
+         * Without a control socket, poll the PTY size every frame. A
+         * headless session reports its client's size the same way.
          *
-         * Direct mode (initscr): SIGWINCH + KEY_RESIZE handled by getch().
+         * Current terminal (initscr): SIGWINCH + KEY_RESIZE handled by getch().
+         * With pipelined output ncurses cannot query the size itself (its
+         * output fd is a pipe), so the real terminal is polled as well.
          */
-        if (g_pty_master_fd >= 0) {
-            struct winsize ws;
-            if (ioctl(g_pty_master_fd, TIOCGWINSZ, &ws) == 0
-                && ws.ws_row > 0 && ws.ws_col > 0) {
-                if (ws.ws_col != COLS || ws.ws_row != LINES) {
-                    resizeterm(ws.ws_row, ws.ws_col);
-                    clearok(curscr, TRUE);
-                }
+        int size_fd = g_pty_master_fd >= 0 ? g_pty_master_fd
+                                           : ncurses_output_pipeline_fd();
+        if (g_direct_tty_fd >= 0) {
+            if (g_sigwinch_pending) {
+                g_sigwinch_pending = 0;
+                apply_terminal_size(g_direct_tty_fd);
             }
+        } else if (g_pty_master_fd >= 0 && ncurses_terminal_control_fd() >= 0) {
+            if (g_control_ready) {
+                g_control_ready = false;
+                if (ncurses_terminal_control_resized()) apply_terminal_size(g_pty_master_fd);
+            }
+        } else if (size_fd >= 0) {
+            apply_terminal_size(size_fd);
         } else if (g_sigwinch_pending) {
             g_sigwinch_pending = 0;
             endwin();
             refresh();
         }
 
-        /* Detect resize */
+        /* Session client attached. Its size was set on the PTY before the
+         * attach was flagged, but the 'W' announcing it may still be
+         * unread: apply it first so the snapshot is painted at that size. */
+        if (ncurses_session_take_attach()) {
+            g_control_ready = false;
+            ncurses_terminal_control_resized();
+            apply_terminal_size(g_pty_master_fd);
+            resume_session_output();
+        }
+
+        /* Detect resize. With a debounce, a new size is only published
+         * after it has held for g_resize_debounce_ms; each change during
+         * a drag restarts the wait. ncurses itself is already resized, so
+         * surfaces are cropped to the terminal until then. */
         int new_w = COLS;
         int new_h = LINES;
         static bool first_frame = true;
         bool resized = first_frame || (new_w != g_last_cols || new_h != g_last_lines);
+        if (resized && !first_frame && g_resize_debounce_ms > 0) {
+            if (!g_resize_pending || new_w != g_pending_cols || new_h != g_pending_lines) {
+                g_resize_pending = true;
+                g_pending_cols = new_w;
+                g_pending_lines = new_h;
+                g_resize_changed_at = g_frame_start;
+            }
+            long quiet_ms = (g_frame_start.tv_sec - g_resize_changed_at.tv_sec) * 1000L
+                          + (g_frame_start.tv_nsec - g_resize_changed_at.tv_nsec) / 1000000L;
+            resized = quiet_ms >= g_resize_debounce_ms;
+        }
+        if (!resized && g_resize_pending
+            && new_w == g_last_cols && new_h == g_last_lines) {
+            g_resize_pending = false;   /* Dragged back to the settled size */
+        }
         if (resized) {
             first_frame = false;
+            g_resize_pending = false;
             g_last_cols = new_w;
             g_last_lines = new_h;
         }
 
-        /* Quit requested (SIGINT) */
-        if (!g_running) {
+        /* Quit requested (SIGINT), or the input reader lost the terminal */
+        if (!g_running || ncurses_input_thread_lost()) {
             cel_mutate(NCurses_WindowState) {
                 NCurses_WindowState.width = g_last_cols;
                 NCurses_WindowState.height = g_last_lines;
                 NCurses_WindowState.running = false;
+                NCurses_WindowState.paused = g_paused;
                 NCurses_WindowState.actual_fps = (g_delta_time > 0.0f) ? 1.0f / g_delta_time : 0.0f;
                 NCurses_WindowState.delta_time = g_delta_time;
             }
@@ -298,12 +468,14 @@ CEL_System(NCurses_WindowUpdateSystem, .phase = PreRender) {
             return;
         }
 
-        /* First frame or resize -- update state to trigger reactivity */
-        if (resized) {
+        /* First frame, resize or pause toggle -- update state to trigger
+         * reactivity */
+        if (resized || g_paused != NCurses_WindowState.paused) {
             cel_mutate(NCurses_WindowState) {
-                NCurses_WindowState.width = new_w;
-                NCurses_WindowState.height = new_h;
+                NCurses_WindowState.width = g_last_cols;
+                NCurses_WindowState.height = g_last_lines;
                 NCurses_WindowState.running = true;
+                NCurses_WindowState.paused = g_paused;
                 NCurses_WindowState.actual_fps = (g_delta_time > 0.0f) ? 1.0f / g_delta_time : 0.0f;
                 NCurses_WindowState.delta_time = g_delta_time;
             }
@@ -315,21 +487,39 @@ CEL_System(NCurses_WindowUpdateSystem, .phase = PreRender) {
  * Frame End: tui_hook_frame_end()
  * ============================================================================
  *
- * FPS throttle -- sleeps to maintain target frame rate.
- * Called by the frame pipeline's frame_end system.
+ * FPS throttle -- sleeps to maintain target frame rate (paused_fps while
+ * paused). Called by the frame pipeline's frame_end system. With the input thread
+ * the sleep waits on its wake pipe, so new input starts the next frame
+ * immediately. In PTY mode it also waits on the relay's control socket, so
+ * a resize does too (checked without sleeping when the frame overran).
  */
 
 void tui_hook_frame_end(void) {
-    float target_delta = 1.0f / (float)g_target_fps;
+    int fps = g_paused ? g_paused_fps : g_target_fps;
+    float target_delta = 1.0f / (float)fps;
 
     struct timespec now;
     clock_gettime(CLOCK_MONOTONIC, &now);
     float elapsed = (float)(now.tv_sec - g_frame_start.tv_sec) +
                     (float)(now.tv_nsec - g_frame_start.tv_nsec) / 1e9f;
 
-    if (elapsed < target_delta) {
-        float remaining = target_delta - elapsed;
-        usleep((unsigned int)(remaining * 1000000));
+    long remaining_us = elapsed < target_delta
+                      ? (long)((target_delta - elapsed) * 1000000) : 0;
+    int control_fd = g_pty_master_fd >= 0 ? ncurses_terminal_control_fd() : -1;
+    if (remaining_us <= 0 && control_fd < 0) return;
+
+    /* With the input thread, input arriving now ends the sleep */
+    if (ncurses_input_thread_active()) {
+        ncurses_input_thread_wait(remaining_us, control_fd, &g_control_ready);
+    } else if (control_fd >= 0) {
+        fd_set rd;
+        FD_ZERO(&rd);
+        FD_SET(control_fd, &rd);
+        struct timeval tv = { .tv_sec = remaining_us / 1000000,
+                              .tv_usec = remaining_us % 1000000 };
+        if (select(control_fd + 1, &rd, NULL, NULL, &tv) > 0) g_control_ready = true;
+    } else {
+        usleep((unsigned int)remaining_us);
     }
 }
 